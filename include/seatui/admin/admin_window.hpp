@@ -1,19 +1,30 @@
 #pragma once
 #include <QMainWindow>
-#include <QtWebSockets/QWebSocketServer>
-#include <QtWebSockets/QWebSocket>
 #include <QList>
+#include <QHash>
+#include <QPointer>
+#include <QLabel>
+#include <QByteArrayView>
+#include <QVector>
+#include <QElapsedTimer>
+#include <seatui/widgets/occupancy_table.hpp>
+#include <seatui/admin/heatmap_timeline.hpp>
+#include <seatui/admin/ws_server_worker.hpp>
+#include <deque>
+#include <memory>
 
-class QTabWidget; class QTableWidget; class QLabel; class QPushButton;
+class QTabWidget; class QTableWidget; class QLabel; class QPushButton; class QProgressBar;
+class QSlider; class QComboBox; class QTimer; class ImageDecodeService;
+class QJsonObject; class HeatmapView; class QThread;
 
 class AdminWindow : public QMainWindow {
     Q_OBJECT
 public:
     explicit AdminWindow(QWidget* parent=nullptr);
+    ~AdminWindow() override;
 
-    // 供 WS/DB 调用：学生求助 JSON 到达
-    // 传入 UTF-8 字节串，如：{"type":"student_help", "description":"...", "image":{...}, "created_at":"..."}
-    Q_SLOT void onHelpArrived(const QByteArray& utf8Json);
+    // 二进制求助帧（见 HelpPacket，已由网络线程解析），图片字节不复制
+    void appendHelpFrame(const HelpPacket::View& v);
 
 private:
     QWidget* buildOverviewPage();
@@ -22,20 +33,65 @@ private:
     QWidget* buildStatsPage();
     QWidget* buildTimelinePage();
 
+    // img 指向 imgOwner 内部（原始帧或解码后的字节），imgOwner 随行保存以保证视图有效。
+    // 缩略图与原图由 decoder_ 在后台解码
     void appendHelpRow(const QString& when, const QString& user,
-                       const QString& text, const QPixmap& thumb,
-                       const QByteArray& rawImgBase64, const QString& mime);
+                       const QString& text,
+                       const QByteArray& imgOwner, QByteArrayView img, const QString& mime);
 
 private:
     QTabWidget* tabs_ = nullptr;
 
     // 求助中心
     QTableWidget* helpTable_ = nullptr;
+    ImageDecodeService*           decoder_ = nullptr;
+    QHash<int, QPointer<QLabel>>  thumbLbls_;       // 行号 → 等待缩略图的单元格
+    int                           helpRowSeq_ = 0;
+
+    // 热力图：{"type":"seat_occupancy","seats":[{"id":N,"state":"occupied|reserved|free"}]}，
+    // N 为座位稳定编号 排 × 100 + 列（SeatLayout::seatKey），与各端窗口尺寸无关
+    void onSeatOccupancy(const QJsonObject& o);
+    HeatmapView* heatView_ = nullptr;
+    QLabel*      heatStat_ = nullptr;
+
+    // 占用统计：前缀和表，总览/分区对比/框选区域都是 O(1) 查询
+    void syncOccupancyLayout();
+    void refreshOccupancyViews();
+    OccupancyTable         occupancy_;
+    QLabel*                occRate_ = nullptr;      // 总览：当前占用率
+    QVector<QProgressBar*> zoneBars_;               // 统计：分区对比 A/B/C/D
+    QVector<QLabel*>       zoneLbls_;
+
+    // 时间轴：占用热力图回放（关键帧 + 增量回放，快进取粗层）
+    void onReplayTick();
+    void seekReplay(qint64 t, int level);
+    void refreshReplayRange();
+    HeatmapTimeline timeline_;
+    HeatmapView*    replayView_   = nullptr;
+    QSlider*        replaySlider_ = nullptr;    // 距开始的秒数
+    QPushButton*    replayPlay_   = nullptr;
+    QComboBox*      replaySpeed_  = nullptr;
+    QLabel*         replayInfo_   = nullptr;
+    QTimer*         replayTimer_  = nullptr;
+    QElapsedTimer   replayClock_;
+    qint64          replayT_      = 0;
 
 
 
     // —— WebSocket 服务端 —— //
+    // 服务端在 netThread_ 上运行（WsServerWorker），入站事件每帧排空一次，出站消息经队列交回网络线程；
+    // 两个方向都没有积压时停掉 netTimer_，由 worker 的 inboundReady 或 sendText 重新启动
+    static constexpr int kNetFrameMs         = 16;
+    static constexpr int kNetEventsPerFrame  = 512;     // 单帧处理上限，余下留给下一帧
     void initWsServer();
-    QWebSocketServer* wsServer_ = nullptr;
-    QList<QWebSocket*> wsClients_ = {};
+    void drainNetwork();
+    void sendText(quint64 client, const QByteArray& utf8);   // client 为 0 时广播
+    void flushOutbound();
+    void sendSeatSnapshot(quint64 client);
+    QThread*                   netThread_ = nullptr;
+    WsServerWorker*            wsWorker_  = nullptr;
+    std::shared_ptr<WsChannel> wsChannel_;
+    std::deque<WsOutbound>     outPending_;              // 出站队列满时暂存
+    QTimer*                    netTimer_  = nullptr;
+    QLabel*                    wsStat_    = nullptr;     // 总览：连接/消息/异常计数，悬停看各类型耗时
 };
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QCache>
+#include <QRect>
+#include <QVector>
+#include <vector>
+#include <seatui/student/seat_layout.hpp>
+#include <seatui/widgets/heatmap_engine.hpp>
+
+// 热力图时间轴回放：按时间记录座位状态事件，每 kKeyIntervalMs 留一份关键帧（座位状态快照）。
+// 关键帧的模糊密度图按需计算，放进按字节计费的 LRU 缓存（QCache），总量不超过 kMaxCacheBytes。
+// 金字塔：第 L 层关键帧间隔 ×4^L、分辨率 /2^L，快进/拖动时直接取最近的粗层关键帧；
+// 正常速度下取最近的第 0 层关键帧再回放其后的事件，顺序播放时直接接着上一帧回放。
+// 只保留最近 kMaxSpanMs / kMaxEvents 以内的历史：超出时按关键帧段整段丢掉最旧的。
+class HeatmapTimeline {
+public:
+    static constexpr qint64 kKeyIntervalMs = 5 * 60 * 1000;
+    static constexpr int    kLevels        = 3;
+    static constexpr qint64 kMaxCacheBytes = qint64(64) << 20;
+    static constexpr qint64 kMaxSpanMs     = qint64(24) * 60 * 60 * 1000;   // 保留时长
+    static constexpr int    kMaxEvents     = 1 << 20;                       // 保留事件数（约 13 MB）
+
+    HeatmapTimeline();
+
+    // 回放视图的布局变了：密度图全部作废（事件与快照保留）
+    void setLayout(const SeatLayout& lay);
+
+    // 追加一条事件；seat 为稳定编号（SeatLayout::seatId），时间需单调不减（乱序的按最后时间记）
+    void record(qint64 ms, int seat, SeatState s);
+
+    bool   isEmpty() const { return times_.empty(); }
+    qint64 startMs() const { return t0_; }
+    qint64 endMs()   const { return times_.empty() ? t0_ : times_.back(); }
+    int    eventCount() const { return int(times_.size()); }
+
+    // 把 engine 带到时刻 t，返回需要重新着色的密度像素范围
+    QRect seek(HeatmapEngine& engine, qint64 t, int level);
+
+    // 回放倍速 → 金字塔层级：60× 以内逐事件回放，越快取越粗的关键帧
+    static int levelForSpeed(qreal speed);
+
+    qint64 cacheBytes()   const { return grids_.totalCost(); }
+    int    lastReplayed() const { return replayed_; }
+
+private:
+    struct Key  { int event = 0; QVector<quint8> states; };   // 关键帧时刻之前的事件数 + 状态快照（按稳定编号）
+    struct Grid { std::vector<float> data; int stride = 0; };
+
+    static float occupancyOf(quint8 s);
+    QVector<float> valuesAt(int key) const;
+    const Grid*    grid(int level, int key);         // 查缓存，缺失时计算并放入
+    QRect          replay(HeatmapEngine& engine, int from, int to);
+    void           trim();                          // 超出保留窗口：丢掉最旧的关键帧段
+
+    // 事件（SoA）
+    std::vector<qint64>  times_;
+    std::vector<qint32>  seats_;                    // 稳定编号，回放时经 lay_ 换算成引擎序号
+    std::vector<quint8>  states_;
+    QVector<quint8>      live_;                     // 录入到最后一条事件时的状态，按稳定编号
+    QVector<Key>         keys_;                     // 第 0 层关键帧；快照隐式共享，空闲时段几乎不占内存
+    qint64               t0_ = 0;
+
+    SeatLayout           lay_;
+    HeatmapEngine        scratch_;                  // 计算关键帧密度图用
+    QCache<quint64, Grid> grids_;                   // (level << 32 | key) → 密度图，按字节计费
+
+    // 回放游标：engine 当前对应的事件位置（-1 表示需要从关键帧载入）
+    int cursorEvent_ = -1;
+    int replayed_    = 0;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QCache>
+#include <QImage>
+#include <QSet>
+#include <QThreadPool>
+
+// 求助中心的图片解码服务：缩略图与原图都在线程池上解码，结果经排队连接回到 GUI 线程。
+// 缩略图用 QImageReader::setScaledSize 直接按小尺寸解码；原图解码后放进按字节计费的
+// LRU 缓存（QCache），重复点“查看”不再重新解码。图片字节以 (owner, view) 传入，全程不复制。
+class ImageDecodeService : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int    kThumbW        = 80;
+    static constexpr int    kThumbH        = 50;
+    static constexpr qint64 kMaxCacheBytes = qint64(256) << 20;
+
+    explicit ImageDecodeService(QObject* parent = nullptr);
+    ~ImageDecodeService() override;
+
+    // owner 持有 bytes 指向的内存（如原始二进制帧），在解码完成前保持有效
+    void requestThumbnail(int key, const QByteArray& owner, QByteArrayView bytes);
+
+    // 原图：命中缓存时返回 true 并通过 out 给出，否则排队解码，完成后发 fullReady
+    bool requestFull(int key, const QByteArray& owner, QByteArrayView bytes, QImage* out);
+
+    qint64 cacheBytes() const { return full_.totalCost(); }
+
+signals:
+    void thumbnailReady(int key, const QImage& thumb);
+    void fullReady(int key, const QImage& image);
+
+private:
+    QThreadPool          pool_;
+    QCache<int, QImage>  full_;
+    QSet<int>            pendingFull_;      // 正在解码的原图，避免连点重复排队
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QHostAddress>
+#include <QJsonObject>
+#include <QSet>
+#include <QString>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <seatui/net/help_packet.hpp>
+#include <seatui/net/spsc_queue.hpp>
+
+class QWebSocket;
+class QWebSocketServer;
+class QTimer;
+class MessageRouter;
+
+// 网络线程 → GUI：已解析、已校验的事件（隐式共享的数据跨线程只移交、不再改）
+struct WsInbound {
+    enum Kind : quint8 { None, ClientConnected, ClientDisconnected, HelpJson, HelpFrame, SeatOccupancy, Stats, ListenFailed };
+    Kind             kind = None;
+    quint64          client = 0;       // 连接编号（跨线程不传 QWebSocket*）
+    QByteArray       bytes;            // HelpJson：已解码的图片字节（可为空）
+    HelpPacket::View frame;            // HelpFrame：帧内视图
+    QJsonObject      object;           // SeatOccupancy
+    QString          text;             // HelpJson：描述；Stats：各类型统计；ListenFailed：错误信息
+    QString          when, user, mime; // HelpJson：其余字段，GUI 直接入表
+    quint64          messages = 0, errors = 0;
+    int              clients = 0;
+};
+
+// GUI → 网络线程：待发送的文本（client 为 0 时广播给全部连接）
+struct WsOutbound {
+    quint64    client = 0;
+    QByteArray text;
+};
+
+// 两个方向的队列；GUI 与 worker 共同持有
+struct WsChannel {
+    static constexpr size_t kCapacity = 4096;
+    SpscQueue<WsInbound>  in  { kCapacity };
+    SpscQueue<WsOutbound> out { kCapacity };
+    std::atomic<bool>     outWake { false };     // 已投递唤醒、网络线程尚未排空
+    std::atomic<bool>     inWake  { false };     // 已发 inboundReady、GUI 尚未排空
+};
+
+// 管理端 WebSocket 服务：整个对象 moveToThread 到专用网络线程，
+// 监听、握手、收发、按 type 分发（MessageRouter）、座位占用转发都在该线程的事件循环里完成，
+// GUI 卡顿（表格刷新、模态框）不再拖慢任何客户端。
+// 入站结果推入 channel->in，GUI 每帧排空一次；队列满时暂存在本地 pending_ 按序重试，不丢。
+// 两端都空闲时 GUI 停掉排空定时器，worker 推入新事件时发 inboundReady（合并，在途只发一次）叫醒它。
+// 学生端发件箱的每一帧处理完就回 {"type":"ack","seq":N}；断线重发的求助按用户 / requestId / 创建时间去重。
+class WsServerWorker : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int kRetryMs = 4;      // 入站队列满时的重试间隔
+    static constexpr int kStatsMs = 1000;   // 统计快照间隔
+    static constexpr int kHelpDedup = 4096; // 记住最近多少条求助用于去重
+
+    explicit WsServerWorker(std::shared_ptr<WsChannel> ch, QObject* parent = nullptr);
+
+    // 在网络线程里调用（用 QMetaObject::invokeMethod 投递）
+    void start(const QHostAddress& host, quint16 port);
+
+    // 任意线程：GUI 推完 channel->out 后调用，合并唤醒网络线程去发送
+    static void wake(WsServerWorker* w, WsChannel* ch);
+
+signals:
+    void inboundReady();                    // 入站队列从 GUI 排空后第一次有新事件
+
+private:
+    void initRoutes();
+    void onNewConnection();
+    void onHelpFrame(QWebSocket* sock, const QByteArray& frame);
+    void acknowledge(QWebSocket* sock, quint64 seq);   // 回 {"type":"ack","seq":N}
+    bool firstHelp(const QByteArray& user, const QByteArray& requestId, const QByteArray& created);
+    void post(WsInbound&& e);
+    void wakeGui();
+    void flushPending();
+    void drainOutbound();
+    void postStats();
+
+    std::shared_ptr<WsChannel> ch_;
+    QWebSocketServer*          server_ = nullptr;
+    MessageRouter*             router_ = nullptr;
+    QHash<quint64, QWebSocket*> clients_;
+    quint64                    nextClient_ = 1;
+    std::deque<WsInbound>      pending_;    // 入站队列满时暂存
+    QTimer*                    retry_ = nullptr;
+    QSet<QByteArray>           seenHelp_;   // 已入表的求助：用户 / requestId / 创建时间
+    std::deque<QByteArray>     seenOrder_;  // 同上，按到达顺序，超出 kHelpDedup 从头淘汰
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QString>
+#include <QTimer>
+#include <QUrl>
+#include <array>
+
+class QWebSocket;
+
+// 最近 kWindow 次往返时延的滚动直方图：对数分桶（<1、1–2、2–4 … ≥1024 ms）供界面展示，
+// 分位数按窗口内样本精确计算（窗口很小，排序一份副本即可）。
+class RttHistogram {
+public:
+    static constexpr int kWindow  = 256;
+    static constexpr int kBuckets = 12;
+
+    void   add(double ms);
+    void   clear();
+    int    count() const { return n_; }
+    double last() const { return n_ ? ring_[(head_ + kWindow - 1) % kWindow] : 0.0; }
+    double mean() const { return n_ ? sum_ / n_ : 0.0; }
+    double percentile(double p) const;                 // p ∈ [0,1]
+    const std::array<int, kBuckets>& buckets() const { return buckets_; }
+    static QString bucketLabel(int i);
+
+    QString summary() const;                           // 单行：p50 / p95 / max / 样本数
+    QString histogramText() const;                     // 多行：各桶计数条形图
+
+private:
+    static int bucketOf(double ms);
+
+    std::array<double, kWindow> ring_ {};
+    std::array<int, kBuckets>   buckets_ {};
+    int    head_ = 0, n_ = 0;
+    double sum_ = 0.0;
+};
+
+// WebSocket 客户端连接管理：
+//  · 重连只走一个单次定时器，disconnected / errorOccurred 重复触发也只排一次；
+//  · 退避为带全抖动的指数退避：delay = rand[kMinDelayMs, min(kMaxDelayMs, kBaseDelayMs·2^n)]，
+//    管理端重启后大量终端的重连时间被打散，不会同一时刻涌入；连上后清零；
+//  · 心跳：连接期间每 kPingMs 发一次 ping（载荷为发送时刻），pong 回来即得 RTT；
+//    超过 kDeadMs 没有收到任何数据判定对端失联，主动 abort 进入重连；握手超过 kConnectTimeoutMs 同样放弃。
+class ConnectionManager : public QObject {
+    Q_OBJECT
+public:
+    enum class State { Idle, Connecting, Connected, Backoff };
+
+    static constexpr int kBaseDelayMs      = 500;
+    static constexpr int kMinDelayMs       = 250;
+    static constexpr int kMaxDelayMs       = 30000;
+    static constexpr int kPingMs           = 5000;
+    static constexpr int kDeadMs           = 15000;
+    static constexpr int kConnectTimeoutMs = 10000;
+
+    explicit ConnectionManager(const QUrl& url, QObject* parent = nullptr);
+
+    QWebSocket* socket() const { return ws_; }
+    void start();                                      // 立即连接
+    void stop();                                       // 断开并停止重连
+
+    State  state() const { return state_; }
+    int    attempt() const { return attempt_; }        // 连续失败次数
+    qint64 retryInMs() const;                          // Backoff 状态下距下次重连的毫秒数
+    const RttHistogram& rtt() const { return rtt_; }
+
+signals:
+    void stateChanged(ConnectionManager::State state);
+    void reconnectScheduled(int delayMs, int attempt);
+    void rttSampled(double ms);
+
+private:
+    void connectNow();
+    void scheduleReconnect();
+    void onConnected();
+    void onDisconnected();
+    void onHeartbeat();
+    void onPong(quint64 elapsedMs, const QByteArray& payload);
+    void setState(State s);
+
+    QUrl        url_;
+    QWebSocket* ws_ = nullptr;
+    QTimer      reconnectTimer_, heartbeatTimer_;
+    QElapsedTimer clock_;                              // 单调时钟：ping 载荷、活跃时间
+    qint64      lastSeenNs_ = 0;                       // 最近一次收到数据（含 pong）
+    qint64      connectStartNs_ = 0;
+    State       state_ = State::Idle;
+    int         attempt_ = 0;
+    bool        stopped_ = true;
+    bool        opening_ = false;                      // connectNow 内部 abort 旧连接时不排重连
+    RttHistogram rtt_;
+};
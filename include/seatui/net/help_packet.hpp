@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+
+// 一键求助的二进制帧（WebSocket binary message），替代 base64-in-JSON：
+//
+//   偏移  长度  字段
+//    0     4    magic "SUHP"
+//    4     1    version（当前 1）
+//    5     1    type（1 = 学生求助）
+//    6     2    flags（保留）
+//    8     4    requestId（发送端自增）
+//   12     8    createdMs（UTC 毫秒）
+//   20     2    userLen      22  2  mimeLen     24  2  nameLen   26  2  保留
+//   28     4    textLen      32  4  imageLen
+//   36     …    user | mime | filename | text（均 UTF-8） | 图片原始字节
+//
+// 整数均为小端。解析只校验长度并记录各段在帧内的位置，不复制图片。
+class HelpPacket {
+public:
+    static constexpr quint8 kVersion    = 1;
+    static constexpr quint8 kTypeHelp   = 1;
+    static constexpr int    kHeaderSize = 36;
+
+    // —— 发送端 —— //
+    quint32    requestId = 0;
+    qint64     createdMs = 0;
+    QString    user, mime, filename, text;
+    QByteArray image;                     // 原始 PNG/JPEG 字节
+
+    QByteArray encode() const;            // 一次分配写出整帧
+
+    // —— 接收端：帧内视图 —— //
+    struct View {
+        QByteArray     frame;             // 原始帧（隐式共享，保证下面的视图有效）
+        quint32        requestId = 0;
+        qint64         createdMs = 0;
+        QByteArrayView user, mime, filename, text, image;
+    };
+
+    static bool isHelpFrame(const QByteArray& frame);
+    static bool parse(const QByteArray& frame, View* out);   // 长度不符/版本不对返回 false
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <array>
+#include <functional>
+#include <seatui/net/connection_manager.hpp>
+
+class QWebSocket;
+
+// 文本消息分发：按 "type" 查哈希表找处理函数。
+// 类型字段由一个只扫顶层成员的轻量扫描器读出（跳过字符串/嵌套值，不建 QJsonDocument），
+// 未注册的类型、缺 type 的坏帧、处理函数拒绝的内容都只计数 + 限频日志，不弹模态框。
+// 每个类型记录处理次数、错误数与处理耗时（总计 / 最大 / 最近 256 次的分布）。
+// 消息总数只数叶子消息：外壳类型（如 batch）自身不计，由其中各条分别计数。
+class MessageRouter : public QObject {
+    Q_OBJECT
+public:
+    // 返回 false 表示内容不合法（计入该类型的错误数）
+    using Handler = std::function<bool(QWebSocket* from, QByteArrayView msg)>;
+
+    enum class Error { Malformed, UnknownType, Rejected };
+    static constexpr int kErrorKinds = 3;
+
+    struct TypeStats {
+        quint64      count = 0, errors = 0;
+        double       totalMs = 0.0, maxMs = 0.0;
+        RttHistogram latency;                  // 最近 256 次处理耗时（ms）
+    };
+
+    explicit MessageRouter(QObject* parent = nullptr);
+
+    // container：该类型只是外壳，处理函数会把其中各条再 dispatch，自身不计入消息总数
+    void on(const QByteArray& type, Handler h, bool container = false);
+    bool dispatch(QWebSocket* from, QByteArrayView msg);    // 已处理且内容合法返回 true
+
+    // 二进制帧等不经 dispatch 的路径也用同一套计数
+    void reportError(Error e, QByteArrayView type, const QString& detail = QString());
+
+    quint64 errorCount(Error e) const { return errors_[int(e)]; }
+    quint64 totalErrors() const;
+    quint64 totalMessages() const { return messages_; }
+    const TypeStats* stats(const QByteArray& type) const;
+    QString statsText() const;                 // 多行：各类型计数与耗时
+
+    // —— 轻量扫描（只认顶层，非法输入返回空视图 / false） —— //
+    static QByteArrayView peekType(QByteArrayView json);
+    static QByteArrayView member(QByteArrayView json, QByteArrayView key);   // 顶层成员值的原始文本
+    static bool items(QByteArrayView array, QVector<QByteArrayView>* out);   // 数组各元素的原始文本
+
+signals:
+    void errorCounted(MessageRouter::Error e, const QString& type, const QString& detail);
+
+private:
+    struct Route { Handler handler; TypeStats stats; bool container = false; };
+
+    QHash<QByteArray, Route>          routes_;
+    std::array<quint64, kErrorKinds>  errors_ {};
+    quint64                           messages_ = 0;
+};
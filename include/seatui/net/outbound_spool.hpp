@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+class QWebSocket;
+
+// 发件箱：先落盘、后发送的追加写队列，断线期间的上报不丢、内存不涨。
+// 学生端目前只往里放二进制求助帧；文本记录与合批留给以后的 JSON 上报。
+//
+// 文件 <dir>/outbox.spool 逐条追加记录：
+//   偏移  长度  字段
+//    0     4    payloadLen（小端）
+//    4     1    kind（0 文本 / 1 二进制）
+//    5     1    保留
+//    6     2    CRC-16（qChecksum，覆盖 payload）
+//    8     …    payload
+// 旁路文件 outbox.ack 存 8 字节“已确认偏移”：此前的记录都已被管理端确认收到。
+// 启动时从确认偏移扫描到尾部，长度/CRC 不符处视为崩溃时的半截记录并截断。
+//
+// fsync 成批做：enqueue 只写进 QFile 缓冲，kSyncMs 内的多条记录共用一次 flush + fsync。
+// 连接后按顺序排空：每个节拍（kDrainMs）最多读 kBatchBytes，文本记录套成
+// {"type":"batch","seq":N,"items":[…]}（相邻小文本合成一帧），二进制记录原样一帧。
+// 帧序号 N 在每次连接内从 1 递增，二进制帧不带序号、按顺序隐式 +1。
+// 管理端处理完回 {"type":"ack","seq":N}（acknowledge），N 及之前的帧才算送达；
+// 在途（已发出未确认）字节超过 kMaxInFlight 即暂停。断线后从确认偏移重发（至少一次），
+// 重复的由管理端按求助的 requestId 去重。
+class OutboundSpool : public QObject {
+    Q_OBJECT
+public:
+    enum class Kind : quint8 { Text = 0, Binary = 1 };
+
+    static constexpr qint64 kMaxSpoolBytes = 64ll << 20;   // 待发字节上限，超出拒收
+    static constexpr int    kMaxSpoolCount = 100000;       // 待发条数上限
+    static constexpr qint64 kMaxInFlight   = 1 << 20;      // 已发未确认的字节上限
+    static constexpr qint64 kCompactBytes  = 8ll << 20;    // 已确认部分超过它就压缩文件
+    static constexpr int    kBatchBytes    = 64 * 1024;    // 每节拍读取上限
+    static constexpr int    kSmallText     = 4 * 1024;     // 可合批的文本消息上限
+    static constexpr int    kSyncMs        = 50;
+    static constexpr int    kDrainMs       = 16;
+
+    explicit OutboundSpool(const QString& dir, QObject* parent = nullptr);
+    ~OutboundSpool() override;
+
+    // 绑定套接字：connected 时开始排空，disconnected 时回退到确认偏移重发
+    void attach(QWebSocket* ws);
+    // 管理端确认：本次连接内帧序号 ≤ seq 的帧都已收到并处理
+    void acknowledge(quint64 seq);
+
+    // 追加一条消息；超出上限或写盘失败返回 false（调用方提示，不会静默丢弃）
+    bool enqueue(Kind kind, const QByteArray& payload);
+
+    // 不落盘、立即发送（握手等只对本次连接有意义的消息）；不占帧序号，管理端也不确认
+    void sendNow(const QString& text);
+
+    int    pendingCount() const { return count_; }
+    qint64 pendingBytes() const { return end_ - acked_; }
+    bool   isOpen() const { return writer_.isOpen() && reader_.isOpen(); }
+
+signals:
+    void backlogChanged(int messages, qint64 bytes);
+
+private:
+    struct Flight { quint64 seq; qint64 end; qint64 bytes; int records; };   // 一帧：序号 / 结束偏移 / 字节 / 记录数
+
+    bool open();
+    void recover();
+    void sync();
+    void drain();
+    void rewind();
+    void compact();
+    void saveAck();
+    void sendFrame(bool binary, const QByteArray& payload, qint64 end, int records, quint64 seq);
+
+    QString dir_;
+    QFile   writer_, reader_, ack_;
+    QWebSocket* ws_ = nullptr;
+    QTimer  syncTimer_, drainTimer_;
+
+    qint64 acked_ = 0;      // 已确认偏移
+    qint64 sent_  = 0;      // 已读出并交给套接字的偏移
+    qint64 end_   = 0;      // 逻辑尾部（含未 flush 的缓冲）
+    qint64 synced_ = 0;     // 已 fsync 的尾部
+    int    count_ = 0;      // 待确认记录数
+
+    quint64 seq_ = 0;       // 本次连接最后发出的帧序号
+    QVector<Flight> flights_;
+    qint64 inFlight_ = 0;   // flights_ 的字节之和
+};
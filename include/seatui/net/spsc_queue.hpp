@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// 单生产者/单消费者无锁环形队列：一个线程只 push，另一个线程只 pop。
+// 容量向上取 2 的幂；head_/tail_ 各占一条缓存行，双方各缓存一份对方的下标，
+// 只有看起来满/空时才去读对方的原子变量（acquire），写自己的下标用 release。
+// 出队后槽位复位为 T()，隐式共享的 QByteArray 等会及时释放。
+template <class T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t n = 2;
+        while (n < capacity) n <<= 1;
+        mask_ = n - 1;
+        buf_.reset(new T[n]);
+    }
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // —— 生产者线程：满时返回 false，v 保持原样（调用方可暂存重试） —— //
+    bool push(T&& v) {
+        const size_t t = tail_.load(std::memory_order_relaxed);
+        if (t - headCache_ > mask_) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (t - headCache_ > mask_) return false;        // 满
+        }
+        buf_[t & mask_] = std::move(v);
+        tail_.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    bool push(const T& v) { T copy(v); return push(std::move(copy)); }
+
+    // —— 消费者线程 —— //
+    bool pop(T& out) {
+        const size_t h = head_.load(std::memory_order_relaxed);
+        if (h == tailCache_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (h == tailCache_) return false;               // 空
+        }
+        out = std::move(buf_[h & mask_]);
+        buf_[h & mask_] = T();
+        head_.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似值（另一端可能正在改），只用于统计显示。
+    // 先读 head 再读 tail：两者都只增不减且 tail 始终不小于 head，这个顺序下差值不会下溢
+    size_t sizeApprox() const {
+        const size_t h = head_.load(std::memory_order_acquire);
+        const size_t t = tail_.load(std::memory_order_acquire);
+        return t >= h ? t - h : 0;
+    }
+
+private:
+    static constexpr size_t kLine = 64;
+
+    alignas(kLine) std::atomic<size_t> head_ { 0 };   // 消费者写
+    size_t tailCache_ = 0;                             // 消费者眼中的 tail
+    alignas(kLine) std::atomic<size_t> tail_ { 0 };   // 生产者写
+    size_t headCache_ = 0;                             // 生产者眼中的 head
+    alignas(kLine) size_t mask_ = 0;
+    std::unique_ptr<T[]> buf_;
+};
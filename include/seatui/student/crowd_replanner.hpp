@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QPoint>
+#include <QPair>
+#include <QVector>
+#include <seatui/student/nav_grid.hpp>
+#include <seatui/student/path_finder.hpp>
+#include <vector>
+
+// 单条路线的增量搜索状态：LPA*，以终点为根反向搜索（起点固定，即不移动机器人的 D* Lite）。
+// 边代价 = 直行 10 / 斜行 14 + 目标格的拥挤附加值。格代价变化后只修复受影响的顶点，
+// 不从头搜索。g_/rhs_ 与网格同尺寸，优先队列为惰性删除的二叉堆。
+class LpaPlanner {
+public:
+    static constexpr quint32 kInf = 0xFFFFFFFFu;
+
+    void reset(const NavGrid& grid, const std::vector<quint16>& pen, const QPoint& start, const QPoint& goal);
+
+    // 进入 c 的代价或 c 的可走性变了：重算 c 及其 8 邻的 rhs（斜行边的切角条件也随之更新）
+    void cellChanged(const NavGrid& grid, const std::vector<quint16>& pen, const QPoint& c);
+
+    // 把队列中不一致的顶点处理到起点一致为止；返回起点是否可达
+    bool compute(const NavGrid& grid, const std::vector<quint16>& pen);
+
+    quint32 cost() const { return startIdx_ >= 0 ? g_[size_t(startIdx_)] : kInf; }
+    QPoint  start() const { return start_; }
+    QPoint  goal()  const { return goal_; }
+    int     lastExpanded() const { return expanded_; }
+
+    // 沿 g 值下降取出路径（含首尾格）
+    NavRoute route(const NavGrid& grid, const std::vector<quint16>& pen) const;
+
+private:
+    struct Key {
+        quint32 k1 = 0, k2 = 0;
+        bool operator<(const Key& o) const { return k1 < o.k1 || (k1 == o.k1 && k2 < o.k2); }
+    };
+    struct Entry { Key key; int idx; };
+
+    Key  calcKey(int idx) const;
+    void updateVertex(const NavGrid& grid, const std::vector<quint16>& pen, int idx);
+    void push(int idx);
+
+    QPoint start_ { -1, -1 }, goal_ { -1, -1 };
+    int    startIdx_ = -1, goalIdx_ = -1;
+    int    cols_ = 0;
+    std::vector<quint32> g_, rhs_;
+    std::vector<Entry>   heap_;
+    int expanded_ = 0;
+};
+
+// 拥挤感知的在途路线集合：持有网格副本与逐格拥挤附加值，每条“腿”一份 LpaPlanner。
+// 附加值与可走性的变化先累积，commit() 时统一修复，只返回总代价真的变了的腿。
+class CrowdReplanner {
+public:
+    void reset(const NavGrid& grid);
+
+    // 设置当前在途路线（每条腿：起点格 → 终点格），立即求解
+    void setLegs(const QVector<QPair<QPoint, QPoint>>& legs);
+    int  legCount() const { return legs_.size(); }
+
+    quint32  legCost(int i) const { return legs_.at(i).cost(); }
+    NavRoute legRoute(int i) const;
+    NavRoute route() const;                 // 各腿首尾相接（拐点按腿拉直）
+
+    // —— 拥挤数据 —— //
+    void addPenalty(const QPoint& cell, int delta);
+    // 格子阻断/放开：与 NavRouter::setCellBlocked 同步调用，网格副本才不会过期
+    void setCellBlocked(const QPoint& cell, bool blocked);
+    bool hasCongestion() const { return congested_ > 0; }
+    QVector<int> commit();                  // 修复全部腿，返回代价变化的腿下标
+
+    double lastRepairMs() const { return repairMs_; }
+    int    lastExpanded() const { return expanded_; }
+
+private:
+    void markDirty(int idx);
+
+    NavGrid                grid_;
+    std::vector<quint16>   pen_;            // 进入该格的附加代价
+    std::vector<int>       dirty_;          // 自上次 commit 以来附加值或可走性变过的格
+    std::vector<quint8>    dirtyMark_;
+    int                    congested_ = 0;  // 附加值非零的格数
+    QVector<LpaPlanner>    legs_;
+
+    double repairMs_ = 0.0;
+    int    expanded_ = 0;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QPoint>
+#include <seatui/student/path_finder.hpp>
+#include <vector>
+
+class NavGrid;
+
+// 单目的地距离场：每格到目标的最短代价（与 PathFinder 相同的 8 邻接 / 10·14 代价）。
+// 建一次 O(N log N)；之后任意起点的路径只需沿梯度下降，代价 O(路径长度)。
+// 网格单格阻断/放开时只修复受影响的区域，不整场重算。
+class DistanceField {
+public:
+    static constexpr quint32 kInf = 0xFFFFFFFFu;
+
+    void build(const NavGrid& grid, const QPoint& goal);
+
+    bool    isEmpty() const { return dist_.empty(); }
+    QPoint  goal()    const { return goal_; }
+    quint32 distance(const QPoint& c) const {
+        return (unsigned(c.x()) < unsigned(cols_) && unsigned(c.y()) < unsigned(rows_))
+                   ? dist_[size_t(c.y() * cols_ + c.x())] : kInf;
+    }
+
+    // 从 from 沿梯度走到目标；不可达返回空路径
+    NavRoute descend(const NavGrid& grid, const QPoint& from) const;
+
+    // —— 增量修复：调用前 grid 中对应格已更新；返回被改写的格数 —— //
+    int cellBlocked(const NavGrid& grid, const QPoint& c);
+    int cellOpened(const NavGrid& grid, const QPoint& c);
+
+private:
+    void relaxFrom(const NavGrid& grid, int& touched);   // 以 heap_ 为种子做 Dijkstra 降值传播
+
+    QPoint goal_ { -1, -1 };
+    int    cols_ = 0, rows_ = 0;
+    std::vector<quint32> dist_;
+
+    // 修复用的暂存（复用，避免每次分配）
+    std::vector<quint64> heap_;      // (距离 << 32) | 下标，小顶堆
+    std::vector<quint32> mark_;      // == gen_ 表示本轮被判为失效
+    std::vector<int>     work_;
+    quint32 gen_ = 0;
+};
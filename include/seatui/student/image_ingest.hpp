@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+// 求助图片的后台处理：解码 → 预览 → 编码，全部在线程池上完成，GUI 线程只接收结果。
+// 解码时用 QImageReader::setScaledSize 直接按上限解码（JPEG 可在 DCT 阶段缩小），
+// 预览与编码并行；编码格式按内容选择：有透明或颜色很少（截图/图标）用 PNG，照片用 JPEG。
+// 每次 submit 换一个代号，旧任务的结果按代号丢弃。
+class ImageIngest : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int kMaxSide     = 2048;   // 上传图片长边上限
+    static constexpr int kPreviewW    = 360;
+    static constexpr int kPreviewH    = 200;
+    static constexpr int kJpegQuality = 85;
+
+    explicit ImageIngest(QObject* parent = nullptr);
+    ~ImageIngest() override;
+
+    quint64 submit(const QString& file);        // 返回本次代号
+    void    cancel();                           // 作废进行中的任务
+    bool    isBusy() const { return busy_; }
+
+signals:
+    void previewReady(quint64 gen, const QImage& preview);
+    void encoded(quint64 gen, const QByteArray& bytes, const QString& mime,
+                 const QString& filename, const QSize& size, double ms);
+    void failed(quint64 gen, const QString& reason);
+
+private:
+    static bool preferPng(const QImage& img, const QByteArray& srcFormat);
+
+    QThreadPool pool_;
+    std::shared_ptr<std::atomic<quint64>> gen_ = std::make_shared<std::atomic<quint64>>(0);
+    bool busy_ = false;
+};
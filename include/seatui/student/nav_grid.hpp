@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QPoint>
+#include <QPointF>
+#include <QRectF>
+#include <vector>
+
+// 导航用可通行网格：与 NavigationCanvas 的 m_cell 网格一一对应。
+// 每格 1 bit（1 = 可走），按行打包成 64 位字，十倍楼层面积也只有几 KB。
+class NavGrid {
+public:
+    NavGrid() = default;
+    NavGrid(const QPoint& origin, int cell, int cols, int rows);
+
+    int    cols()     const { return cols_; }
+    int    rows()     const { return rows_; }
+    int    cellSize() const { return cell_; }
+    QPoint origin()   const { return origin_; }
+    bool   isEmpty()  const { return cols_ <= 0 || rows_ <= 0; }
+    int    cellCount() const { return cols_ * rows_; }
+
+    inline bool inBounds(int x, int y) const {
+        return unsigned(x) < unsigned(cols_) && unsigned(y) < unsigned(rows_);
+    }
+    // 越界一律视为不可走，寻路内层循环无需再判边界
+    inline bool walkable(int x, int y) const {
+        if (!inBounds(x, y)) return false;
+        return (bits_[size_t(y) * stride_ + (unsigned(x) >> 6)] >> (x & 63)) & 1u;
+    }
+    inline bool walkable(const QPoint& c) const { return walkable(c.x(), c.y()); }
+    inline int  index(int x, int y) const { return y * cols_ + x; }
+    inline QPoint cellOf(int idx) const { return QPoint(idx % cols_, idx / cols_); }
+
+    void setWalkable(int x, int y, bool on);
+    void fill(bool walkable);
+
+    // 以“格心落在矩形内”为准，把像素矩形覆盖的格子置为不可走
+    void blockRect(const QRectF& px);
+
+    // 像素 ↔ 格坐标
+    QPoint  cellAt(const QPointF& px) const;
+    QPointF cellCenter(const QPoint& c) const;
+
+    // 就近可走格（BFS）；找不到返回 (-1,-1)
+    QPoint nearestWalkable(const QPoint& c) const;
+
+private:
+    QPoint origin_;          // 第 (0,0) 格左上角像素
+    int    cell_   = 1;
+    int    cols_   = 0;
+    int    rows_   = 0;
+    int    stride_ = 0;      // 每行 64 位字数
+    std::vector<quint64> bits_;
+};
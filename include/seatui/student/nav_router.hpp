@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QHash>
+#include <QPoint>
+#include <QVector>
+#include <seatui/student/nav_grid.hpp>
+#include <seatui/student/path_finder.hpp>
+#include <seatui/student/distance_field.hpp>
+
+// 导航路由：持有当前布局的可通行网格，回答 START → 书架 的查询。
+// reset() 时为每个书架预建一张距离场，此后任意起点到书架只需沿梯度走 O(路径长度)；
+// START 出发的路径再按目的地缓存，只有布局变化或格子阻断时才失效。
+class NavRouter {
+public:
+    void reset(const NavGrid& grid, const QPoint& startCell, const QVector<QPoint>& goalCells);
+
+    const NavGrid& grid()      const { return grid_; }
+    QPoint         startCell() const { return start_; }
+    int            goalCount() const { return goals_.size(); }
+    QPoint         goalCell(int i) const { return goals_.value(i, QPoint(-1, -1)); }
+
+    // 到第 goal 个目的地的路径；找不到返回空路径
+    NavRoute routeTo(int goal);
+    // 任意起点（座位/终端位置）到第 goal 个目的地：沿距离场下降
+    NavRoute routeFrom(const QPoint& fromCell, int goal) const;
+    // 任意两点（非预设目的地）：A*/JPS
+    NavRoute route(const QPoint& fromCell, const QPoint& toCell);
+
+    const DistanceField* field(int goal) const {
+        return (goal >= 0 && goal < fields_.size()) ? &fields_.at(goal) : nullptr;
+    }
+
+    // —— 多点路线 —— //
+    // 任意兴趣点（START/书架/座位旁的过道格）的距离场：书架直接复用，其余按格缓存，
+    // 最多留 kMaxPoiFields 张（LRU），内存与阻断修复的开销都有上限。
+    // distanceMatrix 建的场一直钉住到 routeThrough 结束，同一次求解不会把某张场建两遍；
+    // 调用方应让兴趣点（不含书架）不超过 kMaxPoiFields 个。
+    // 返回的引用只保证到下一次 fieldAt 调用为止
+    static constexpr int kMaxPoiFields = 32;
+    const DistanceField& fieldAt(const QPoint& cell);
+    // 兴趣点两两代价（n×n 行优先）；同一组兴趣点重复查询直接返回缓存
+    const QVector<quint32>& distanceMatrix(const QVector<QPoint>& pois);
+    // 依次经过 stops（stops[0] 为出发格）：逐段沿距离场下降后拼接，拐点按段拉直（不跨越途经点）
+    NavRoute routeThrough(const QVector<QPoint>& stops);
+
+    // 单格阻断/放开（如临时封闭的过道）：增量修复各距离场，返回被改写的格数
+    int setCellBlocked(const QPoint& cell, bool blocked);
+
+    // —— 最近一次查询的统计（用于状态栏/日志） —— //
+    double lastQueryMs()   const { return lastMs_; }
+    bool   lastWasCached() const { return lastCached_; }
+    double lastBuildMs()   const { return buildMs_; }   // 距离场建立/修复耗时
+
+private:
+    NavRoute withCorners(NavRoute route) const;   // 补上拉直后的拐点
+    void     unpinPoiFields();
+
+    NavGrid         grid_;
+    PathFinder      finder_;
+    QPoint          start_ { -1, -1 };
+    QVector<QPoint> goals_;
+    QVector<DistanceField> fields_;
+    QHash<int, NavRoute> cache_;
+
+    struct PoiField { DistanceField field; quint64 used = 0; bool pinned = false; };
+    QHash<int, PoiField> poiFields_;        // 键为格下标
+    quint64          poiTick_ = 0;          // LRU 时钟
+    QVector<QPoint>  matrixPois_;
+    QVector<quint32> matrix_;
+
+    double lastMs_     = 0.0;
+    double buildMs_    = 0.0;
+    bool   lastCached_ = false;
+};
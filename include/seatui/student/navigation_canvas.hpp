@@ -3,13 +3,30 @@
 #include <QObject>
 #include <QWidget>
 #include <QImage>
+#include <QPixmap>
 #include <QVector>
+#include <QHash>
 #include <QPoint>
+#include <QPolygonF>
+#include <QPainterPath>
 #include <QRect>
 #include <QPaintEvent>
 #include <QResizeEvent>
-
-class QPainter;
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <QPainter>
+#include <QTransform>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QStringList>
+#include <seatui/student/nav_router.hpp>
+#include <seatui/student/scene_tile_cache.hpp>
+#include <seatui/student/route_glow.hpp>
+#include <seatui/student/tour_planner.hpp>
+#include <seatui/student/crowd_replanner.hpp>
+#include <seatui/student/seat_layout.hpp>
+#include <seatui/student/seat_spatial_index.hpp>
+#include <seatui/student/seat_sprite_atlas.hpp>
 
 class NavigationCanvas : public QWidget {
     Q_OBJECT
@@ -17,45 +34,186 @@ public:
     explicit NavigationCanvas(QWidget* parent = nullptr);
     void setSuperSample(bool on);
 
+    // —— 画质调度：交互/动画期间直接抗锯齿，空闲后补一次 SSAA 精修 —— //
+    void beginInteraction();
+    bool isInteractive() const { return m_interactive; }
+
+    // —— 视口：滚轮缩放（以光标为中心），右键/中键拖动平移；缩放 1 = 整层适配窗口 —— //
+    qreal zoom() const { return m_zoom; }
+    void  setView(qreal zoom, const QPointF& pan);
+    void  resetView();
+    void  zoomAt(const QPointF& screenPos, qreal factor);
+
+    // —— 路径 —— //
+    bool showRoute(int shelf);            // 规划并显示 START → 书架（0..3 对应 A..D）
+    void clearRoute();
+    const NavRouter& router() const { return m_router; }
+    const SeatLayout& seatLayout() const { return lay; }
+
+    // —— 多点路线：START → 若干书架（及当前选中的座位），顺序自动求解 —— //
+    bool showTour(const QVector<int>& shelves);
+    const TourPlanner::Tour& lastTour() const { return m_tour; }
+    const QStringList& tourStops() const { return m_tourStops; }   // 按访问顺序的站名
+    int tourSeatsDropped() const { return m_tourSeatsDropped; }    // 超出上限、没排进路线的选中座位数
+
+    // —— 选座 —— //
+    const QVector<int>& selectedSeats() const { return m_selectedIds; }
+    int  hoveredSeat() const { return m_hoverSeat; }
+    void clearSelection();
+
+    // —— 实时座位状态（空闲/占用/预约），按稳定编号（SeatLayout::seatId，即消息里的 id） —— //
+    // 当前布局没排到的座位也记下，窗口放大排出来后随即生效
+    void      setSeatState(int id, SeatState s);
+    SeatState seatState(int id) const {
+        return SeatState(m_seatById.value(id, quint8(SeatState::Free)));
+    }
+
+    // 临时封闭/放开一个过道格：距离场与在途路线的增量规划器一起修复，返回距离场改写的格数
+    int setCellBlocked(const QPoint& cell, bool blocked);
+
+signals:
+    void seatHovered(int seat);           // 悬停座位变化，-1 表示离开座位
+    void selectionChanged(int count);     // 选中集合变化
+    void routeFrameStats(double avgMs, double peakMs, int particles); // 路径动画每帧 CPU（约每秒一次）
+    void routeReplanned(quint32 cost, double repairMs, int legs);     // 拥挤变化导致当前路线代价改变
+
 protected:
     void paintEvent(QPaintEvent*) override;
     void resizeEvent(QResizeEvent*) override;
+    void mousePressEvent(QMouseEvent* e) override;
+    void mouseMoveEvent(QMouseEvent* e) override;
+    void mouseReleaseEvent(QMouseEvent* e) override;
+    void mouseDoubleClickEvent(QMouseEvent* e) override;
+    void wheelEvent(QWheelEvent* e) override;
+    void leaveEvent(QEvent* e) override;
+    void showEvent(QShowEvent* e) override;
+    void hideEvent(QHideEvent* e) override;
 
 private:
-    struct Layout {
-        int   W = 0, H = 0;
-        int   margin = 0;
-        QRect rectInner;              // 主绘制区域
-        QVector<QPoint> shelfCenters; // 顶部 A/B/C/D 中心
-        QPoint startPt;               // 起点（对齐到网格）
-    } lay;
-
-    // —— 网格与座位参数 —— //
-    int   m_cell        = 15;   // 主网格像素（可微调：18~26）
-    int   m_seatCols    = 4;    // 座位横向格数
-    int   m_seatRows    = 2;    // 座位纵向格数
-    int   m_aisleXCells = 1;    // 座位间横向普通走道宽度（格）
-    int   m_aisleYCells = 1;    // 座位间纵向普通走道宽度（格）
-    int   m_mainEvery   = 4;    // 每多少个座位插入一次主走道
-    int   m_mainWCells  = 2;    // 主走道宽度（格）
-    int   m_topReserve  = 3;    // 顶部为书架标签预留的高度（格）
-    int   m_borderCells = 1;    // 四周边框留白（格）
-    qreal m_seatGap     = 2.0;  // 座位矩形像素级内缩
-    qreal m_seatRadius  = 8.0;  // 座位圆角
-
-    bool  useSSAA = true;
-    QImage msaaBuffer;
+    // —— 布局模型（updateLayout 时计算一次，绘制只读） —— //
+    SeatLayout::Params m_params;
+    SeatLayout         lay;
+
+    bool  useSSAA = true;                 // 用户偏好（复选框）
+    bool  m_interactive = false;          // 正在缩放/动画：暂不做 SSAA
+    QTimer m_refineTimer;                 // 空闲后触发一次精修（单次、可重启）
+    static constexpr int kRefineDelayMs = 180;
+
+    // —— 视口：屏幕 = 世界 × m_zoom + m_pan —— //
+    static constexpr qreal kMinZoom = 0.25;
+    static constexpr qreal kMaxZoom = 8.0;
+    qreal      m_zoom = 1.0;
+    QPointF    m_pan;
+    QTransform m_view, m_viewInv;       // 世界→屏幕 及其逆
+    bool       m_panning = false;
+    QPoint     m_panLast;
+
+    // —— LOD 阈值（屏幕像素）—— //
+    static constexpr qreal kMinorGridMinPx   = 6.0;   // 格子小于此值不画细网格线
+    static constexpr qreal kSeatOutlineMinPx = 16.0;  // 座位宽小于此值不画描边
+    static constexpr qreal kSeatLabelMinPx   = 80.0;  // 座位宽大于此值显示座位号（适配视图下约 56）
+    static constexpr int   kMaxDamageRects   = 8;     // 损伤矩形多于此数时合并为包围盒
+    static constexpr qreal kRouteCornerCells = 1.0;   // 路径拐角倒圆半径（格）
+
+    // —— 静态层：背景/网格/书架切成瓦片，在线程池里光栅化，平移时直接复用 —— //
+    SceneTileCache m_tiles;
+    bool           m_staticDirty = true;  // 布局变化：需要给瓦片缓存换新场景快照
+
+    // —— 寻路 —— //
+    NavRouter m_router;
+    NavRoute  m_route;
+    int       m_routeShelf = -1;        // 当前显示的目的地（多点路线为最后一站的书架），-1 表示无
+    bool      m_tourActive = false;     // 当前显示的是多点路线（布局变化时按同样的站点重排）
+    QVector<int> m_tourShelves;
+    TourPlanner::Tour m_tour;
+    QStringList  m_tourStops;
+    int          m_tourSeatsDropped = 0;
+
+    // —— 拥挤感知：占用/预约座位给周围过道加代价，在途路线增量修复 —— //
+    static constexpr int kCrowdOccupied = 6;   // 每张占用座位给一圈过道格加的代价（直行一步为 10）
+    static constexpr int kCrowdReserved = 2;
+    CrowdReplanner m_crowd;
+    QTimer         m_replanTimer;       // 合并一批座位状态变化后统一修复
+    bool           m_rerouteForced = false; // 当前路线上有格子被封：代价不变也要换线
+    QPolygonF    m_routeLine;           // 拉直后的折线（像素坐标），路径变化时生成
+    QPainterPath m_routePath;           // 拐角倒圆后的贝塞尔路径，绘制与动画都用它
+    QRectF    m_routeBounds;            // 折线包围盒（世界坐标，含光晕），局部重绘时判断是否相交
+
+    // —— 路径动画：发光 + 流动粒子，约 60 fps，只重绘路径包围盒 —— //
+    RouteGlow     m_glow;
+    QTimer        m_animTimer;
+    QElapsedTimer m_animClock;
+    int           m_statFrames = 0;
+
+    // —— 命中测试与选座 —— //
+    SeatSpatialIndex m_index;           // 布局变化时重建
+    int            m_hoverSeat = -1;
+    QVector<quint8> m_selected;         // 每座位一个标记，O(1) 判定
+    QVector<int>   m_selectedIds;       // 选中座位列表（绘制/对外）
+    bool           m_pressed = false;
+    QPoint         m_pressPos;
+    QRect          m_rubber;            // 框选矩形（为空表示未在框选）
+
+    // —— 座位：实时状态 + 精灵批量绘制 —— //
+    QHash<int, quint8> m_seatById;      // 非空闲座位的 SeatState，按稳定编号；布局重建时据此重铺
+    QVector<quint8>  m_seatState;       // SeatState，按本布局座位序号
+    SeatSpriteAtlas  m_atlas;           // 座位尺寸/DPR/SSAA 变化时重建
+    QVector<QPainter::PixmapFragment> m_seatFragments; // 每座位一个片段，状态变化时原地改源矩形
+    bool             m_fragmentsDirty = true;
+    QVector<int>     m_visibleSeats;    // 视口裁剪后的座位（复用缓冲）
+    QVector<QPainter::PixmapFragment> m_visibleFragments;
 
 private:
     // —— 绘制 —— //
     void updateLayout(int W, int H);
-    void drawScene(QPainter& p, const QSize& sz);
-    void drawBackgroundGrid(QPainter& p); // 只画主网格（含加粗的 4 格分界）
-    void drawShelvesLabels(QPainter& p);
-    void drawSeats(QPainter& p);          // 4×2 座位，留出走道
+    void rebuildNavGrid();                // 由布局栅格化出可通行网格
+    void invalidateStatic();              // 布局变化：静态场景换代并请求重绘
+    qreal superSampleFactor() const;      // 当前应使用的 SSAA 倍数（相对设备像素）
+    void onRefineTimeout();
+    void rebuildScene();                  // 以当前布局快照重置瓦片缓存
+
+    // 静态场景（世界坐标，只画 vis 内）：只读传入的布局快照，可在工作线程调用
+    static void drawScene(QPainter& p, const SeatLayout& lay, qreal zoom, const QRectF& vis);
+    static void drawBackgroundGrid(QPainter& p, const SeatLayout& lay, qreal zoom, const QRectF& vis);
+    static void drawShelvesLabels(QPainter& p, const SeatLayout& lay, const QRectF& vis);
+
+    void drawOverlays(QPainter& p, const QRectF& dirty); // 动态叠加：标记/路径（只画与 dirty 相交的）
+    void drawSeats(QPainter& p, const QRectF& vis); // 座位：一次 drawPixmapFragments 贴出可见精灵
+    void drawSeatLabels(QPainter& p, bool all); // 放大后在可见座位上标座位号
     void drawStartMark(QPainter& p);
+    QRectF startMarkBounds() const;       // 起点圆点与文字的大致范围（世界坐标）
+    void drawRoute(QPainter& p, const QRectF& dirty);
+    void drawSelection(QPainter& p);      // 悬停高亮（世界坐标）
+    void drawRubberBand(QPainter& p);     // 框选矩形（屏幕坐标）
+    void setRoute(const NavRoute& route); // 记录路径并生成折线
+    bool planTour();                      // 按 m_tourShelves 与当前选座求解并显示
+    void setActiveRoute(const NavRoute& plain, const QVector<QPair<QPoint, QPoint>>& legs);
+    void applySeatCrowd(int seat, int delta);
+    static int crowdWeight(SeatState s) {
+        return s == SeatState::Occupied ? kCrowdOccupied : s == SeatState::Reserved ? kCrowdReserved : 0;
+    }
+    void onReplan();
+    void updateAnimation();               // 有路径且可见时才跑动画定时器
+    void onAnimTick();
+
+    // —— 视口辅助 —— //
+    void    applyView();                  // 由 m_zoom/m_pan 更新变换并失效缓存
+    void    clampView();                  // 平移不让楼层完全移出窗口
+    QRectF  visibleWorldRect() const { return m_viewInv.mapRect(QRectF(rect())); }
+    QPointF toWorld(const QPointF& screen) const { return m_viewInv.map(screen); }
+    qreal   seatScreenWidth() const { return lay.seatSize.width() * m_zoom; }
+
+    // —— 选座辅助 —— //
+    QRect seatDamageRect(int seat) const; // 座位重绘区域（含描边外扩）
+    void  setHover(int seat);
+    void  setSeatSelected(int seat, bool on);
+    void  resetSelection();               // 清空选中（不发信号）
 
-    // —— 辅助 —— //
-    inline int snapUp(int v, int s)  const { return ((v + s - 1) / s) * s; }
-    inline int snapDn(int v, int s)  const { return  (v / s) * s; }
+    // —— 座位精灵辅助 —— //
+    SeatState visualState(int seat) const {
+        return m_selected.value(seat) ? SeatState::Selected
+                                      : SeatState(m_seatState.value(seat, quint8(SeatState::Free)));
+    }
+    void ensureSeatSprites();             // 图集/片段与当前 DPR、布局保持一致
+    void refreshFragment(int seat);
 };
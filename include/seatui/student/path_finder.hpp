@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QPoint>
+#include <QVector>
+#include <vector>
+
+class NavGrid;
+
+// 一条网格路径：起点 → 终点的格坐标序列
+struct NavRoute {
+    QVector<QPoint> cells;
+    QVector<QPoint> corners;     // 视线拉直后的拐点（含首尾），由 NavRouter 填充并随路径缓存
+    quint32 cost = 0;            // 直行 10 / 斜行 14 累加
+    bool isValid() const { return !cells.isEmpty(); }
+};
+
+// 8 邻接 A*（八方向距离启发、禁止切角）。
+// 内部数组按代次（generation）复用，单次查询不做 O(格数) 的清零。
+class PathFinder {
+public:
+    static constexpr quint32 kStraight = 10;
+    static constexpr quint32 kDiagonal = 14;
+
+    NavRoute find(const NavGrid& grid, const QPoint& from, const QPoint& to);
+
+    int lastExpanded() const { return expanded_; }   // 上次查询展开的节点数
+
+    static quint32 octile(int dx, int dy) {
+        dx = qAbs(dx); dy = qAbs(dy);
+        return kStraight * quint32(dx + dy) - (2 * kStraight - kDiagonal) * quint32(qMin(dx, dy));
+    }
+
+private:
+    void prepare(int cellCount);
+
+    struct Node { quint32 f; quint32 h; qint32 idx; };
+
+    std::vector<quint32> g_;
+    std::vector<qint32>  parent_;
+    std::vector<quint32> seen_;     // == gen_ 表示本轮 g_/parent_ 有效
+    std::vector<quint32> closed_;   // == gen_ 表示本轮已出队
+    std::vector<Node>    open_;     // 二叉堆（允许重复入堆，出队时惰性丢弃）
+    quint32 gen_ = 0;
+    int expanded_ = 0;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPixmap>
+#include <QRectF>
+#include <QVector>
+#include <vector>
+
+// 路径发光动画：光晕来自一张预先模糊好的“描边精灵”（路径或缩放变化时生成一次），
+// 粒子按结构数组存放、沿弧长匀速流动，每帧一次 drawPixmapFragments 贴出。
+// 粒子数量受帧预算约束：上一秒平均每帧 CPU 超出预算就减半，远低于预算再逐步加回。
+class RouteGlow {
+public:
+    static constexpr int   kMaxParticles = 256;
+    static constexpr qreal kBudgetMs     = 2.0;    // 每帧 CPU 预算（推进 + 绘制）
+
+    void setPath(const QPainterPath& path);        // 世界坐标；空路径即关闭
+    void clear() { setPath(QPainterPath()); }
+    bool isActive() const { return length_ > 0; }
+
+    // 世界坐标包围盒（含光晕与粒子外扩），用于局部重绘
+    QRectF bounds() const { return bounds_; }
+
+    // 推进 dt 秒；粒子位置更新是无分支的连续数组循环，可被编译器向量化
+    void advance(qreal dt);
+
+    // 在世界坐标的 painter 上绘制光晕与粒子；zoom/dpr 决定光晕精灵的分辨率
+    void draw(QPainter& p, qreal zoom, qreal dpr);
+
+    // —— 帧耗时统计（毫秒） —— //
+    qreal frameMs() const { return frameMs_; }     // 指数平均
+    qreal peakMs()  const { return peakMs_; }      // 最近一个统计窗口内的峰值
+    int   particleCount() const { return count_; }
+
+private:
+    void buildArcTable();
+    void rebuildGlow(qreal zoom, qreal dpr);
+    void rebuildParticleSprite(qreal dpr);
+    void spawn(int from, int to);
+    void account(qreal ms);                        // 记一帧耗时并按预算调整粒子数
+
+    QPainterPath path_;
+    QRectF       bounds_;
+    qreal        length_ = 0;
+    qreal        time_   = 0;
+
+    // 弧长表：折线顶点与累计长度
+    std::vector<float> px_, py_, cum_;
+
+    // 粒子（SoA）
+    std::vector<float> s_, v_, phase_;
+    int count_ = 0;
+    QVector<QPainter::PixmapFragment> fragments_;
+
+    // 光晕精灵（世界坐标 glowRect_ 范围，低分辨率 + 模糊）
+    QPixmap glow_;
+    QRectF  glowRect_;
+    qreal   glowZoom_ = 0, glowDpr_ = 0;
+
+    QPixmap particle_;
+    qreal   particleDpr_ = 0;
+
+    // 统计
+    qreal frameMs_ = 0, peakMs_ = 0, windowPeak_ = 0, pendingMs_ = 0;
+    int   windowFrames_ = 0;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QPoint>
+#include <QPainterPath>
+#include <QPolygonF>
+#include <QVector>
+
+class NavGrid;
+
+// 路径后处理：先在可通行网格上做视线拉直（string pulling），去掉锯齿状的格点，
+// 再在每个拐角用一段三次贝塞尔倒圆。两步都与路径长度成线性关系。
+class RouteSmoother {
+public:
+    // 单段视线检查最多跨越的路径步数：把拉直的最坏代价限制为 O(kMaxPull × 路径长度)
+    static constexpr int kMaxPull = 48;
+
+    // 两格心连线经过的格子（含对角穿过格角时的两侧格）是否都可走
+    static bool lineOfSight(const NavGrid& grid, const QPoint& a, const QPoint& b);
+
+    // 拉直：返回保留下来的拐点（含首尾格）
+    static QVector<QPoint> stringPull(const NavGrid& grid, const QVector<QPoint>& cells);
+
+    // 折线 → 直线段 + 拐角贝塞尔；倒圆半径不超过 maxRadius，也不超过相邻线段的一半
+    static QPainterPath fitBezier(const QPolygonF& pts, qreal maxRadius);
+};
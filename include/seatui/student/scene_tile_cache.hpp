@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QImage>
+#include <QPixmap>
+#include <QPointF>
+#include <QRect>
+#include <QRectF>
+#include <QThreadPool>
+#include <QPainter>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// 瓦片键：缩放（定点量化）+ 缩放后世界坐标里的瓦片行列。平移不改变键，平移时瓦片可直接复用。
+struct SceneTileKey {
+    qint64 zoom = 0;
+    int    tx = 0, ty = 0;
+    bool operator==(const SceneTileKey& o) const { return zoom == o.zoom && tx == o.tx && ty == o.ty; }
+};
+inline size_t qHash(const SceneTileKey& k, size_t seed = 0) noexcept {
+    return qHashMulti(seed, k.zoom, k.tx, k.ty);
+}
+
+// 静态场景瓦片缓存：把场景切成固定大小的瓦片，缺失/待精修的瓦片交给线程池在 QImage 上光栅化，
+// 完成后回到 GUI 线程转成 QPixmap 合成。场景（布局/DPR）变化时整代作废，缩放变化时排队中的旧瓦片作废。
+class SceneTileCache : public QObject {
+    Q_OBJECT
+public:
+    // 在世界坐标下绘制 world 范围内的静态内容；会在工作线程调用，只能读取自己捕获的快照
+    using PaintFn = std::function<void(QPainter& p, const QRectF& world, qreal zoom)>;
+
+    static constexpr int    kTileSize  = 256;                 // 逻辑像素
+    static constexpr qint64 kMaxBytes  = 96ll * 1024 * 1024;  // 瓦片显存/内存上限
+
+    explicit SceneTileCache(QObject* parent = nullptr);
+    ~SceneTileCache() override;
+
+    // 新场景：丢弃全部瓦片并让排队中的任务失效
+    void  setScene(PaintFn paint, qreal dpr);
+    qreal dpr() const { return dpr_; }
+
+    // 期望的超采样倍数；已有瓦片低于该倍数时在后台重绘，重绘完成前继续显示旧瓦片
+    void  setQuality(qreal ss) { ss_ = ss; }
+
+    // 每次重绘开始时调用一次：推进帧号（LRU 以帧为单位）并记下视口（屏幕 = 世界 × zoom + pan）
+    void beginFrame(qreal zoom, const QPointF& pan);
+
+    // 按本帧视口合成 screen 范围内的瓦片，缺失的排队渲染；一帧内可按各损伤矩形多次调用。
+    // 返回 false 表示还有瓦片在路上（画面暂时用旧缩放的瓦片或底色顶替）
+    bool draw(QPainter& p, const QRect& screen);
+
+    int  pendingCount() const { return pending_.size(); }
+
+signals:
+    void tileReady(const QRect& screenRect);   // 当前视口下需要重绘的区域
+
+private:
+    struct Tile {
+        QPixmap pm;
+        qreal   ss   = 1.0;
+        quint64 used = 0;    // 最近一次被合成的帧号（LRU）
+    };
+    // 任务与缓存共享的“当前”状态，任务开始前据此判断自己是否已过期
+    struct Shared {
+        std::atomic<quint64> gen{0};
+        std::atomic<qint64>  zoom{0};
+    };
+
+    static qint64 zoomKey(qreal zoom) { return qRound64(zoom * 65536.0); }
+    static QImage renderTile(const PaintFn& paint, const SceneTileKey& key, qreal zoom, qreal dpr, qreal ss);
+
+    void request(const SceneTileKey& key, qreal zoom);
+    void onTileDone(const SceneTileKey& key, quint64 gen, qreal ss, const QImage& img);
+    bool drawFallback(QPainter& p, const QRectF& target, qreal zoom, const QPointF& pan);
+    void evict();
+
+    QThreadPool pool_;
+    std::shared_ptr<Shared> shared_ = std::make_shared<Shared>();
+    PaintFn paint_;
+    quint64 gen_ = 0;
+    qreal   dpr_ = 1.0;
+    qreal   ss_  = 1.0;
+
+    QHash<SceneTileKey, Tile> tiles_;
+    QSet<SceneTileKey>        pending_;
+    qint64  bytes_ = 0;
+    quint64 frame_ = 0;
+
+    // 上一次合成时的视口：回调里把瓦片换算回屏幕区域；缩放切换时作为顶替来源
+    qreal   zoom_ = 0.0;
+    QPointF pan_;
+    qreal   fallbackZoom_ = 0.0;
+    bool    lastComplete_ = false;   // 本帧（换帧时即上一帧）各矩形是否全部命中；只有完整的缩放级别才拿来顶替
+};
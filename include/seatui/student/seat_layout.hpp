@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QPoint>
+#include <QRect>
+#include <QRectF>
+#include <QSizeF>
+#include <QVector>
+
+// 座位的实时状态（Selected 为本机选中的显示态，不来自后端）
+enum class SeatState : quint8 { Free = 0, Occupied, Reserved, Selected, Count };
+
+// 座位布局模型：由 NavigationCanvas::updateLayout 按窗口尺寸计算一次，
+// 渲染、命中测试、寻路与热力图共用。座位属性按“结构数组”存放，下标即座位序号。
+// 序号随窗口尺寸变化，只在本布局内有效；跨客户端、跨布局（消息、回放）一律用稳定编号 seatId。
+class SeatLayout {
+public:
+    // —— 座位稳定编号：排 × kKeyStride + 列，只取决于座位在平面图里的排与列 —— //
+    static constexpr int kKeyStride = 100;        // 每排最多列数
+    static constexpr int kMaxRows   = 100;        // 最多排数（超出的不排座位）
+    static constexpr int kMaxSeats  = kMaxRows * kKeyStride;
+    static int  seatKey(int row, int col) { return row * kKeyStride + col; }
+    static bool isValidKey(int key) { return key >= 0 && key < kMaxSeats; }
+
+    // —— 网格与座位参数 —— //
+    struct Params {
+        int   cell        = 15;   // 主网格像素（可微调：18~26）
+        int   seatCols    = 4;    // 座位横向格数
+        int   seatRows    = 2;    // 座位纵向格数
+        int   aisleXCells = 1;    // 座位间横向普通走道宽度（格）
+        int   aisleYCells = 1;    // 座位间纵向普通走道宽度（格）
+        int   mainEvery   = 4;    // 每多少列座位插入一次竖向主走道（0 为不设）
+        int   mainWCells  = 2;    // 主走道宽度（格）
+        int   topReserve  = 3;    // 顶部为书架标签预留的高度（格）
+        int   borderCells = 1;    // 四周边框留白（格）
+        qreal seatGap     = 2.0;  // 座位矩形像素级内缩
+        qreal seatRadius  = 8.0;  // 座位圆角
+        int   shelfCount  = 4;    // 顶部书架数（A/B/C/D）
+    };
+
+    // 像素半开区间 [from, to)
+    struct Span { int from = 0; int to = 0; };
+
+    static SeatLayout build(const Params& prm, int W, int H);
+
+    // —— 整体 —— //
+    Params prm;
+    int    W = 0, H = 0;
+    int    margin = 0;
+    QRect  rectInner;             // 主绘制区域
+    QRect  gridRect;              // 对齐网格的区域（左上 Lg,Tg；宽高为 cell 整数倍）
+    int    gridCols = 0, gridRows = 0;
+    QPoint startPt;               // 起点（对齐到网格交点）
+
+    // —— 书架 —— //
+    QVector<QRect> shelfRects;    // 徽标矩形（对齐网格）
+    QVector<Span>  shelfZones;    // 每个书架对应的横向分栏
+
+    // —— 座位（SoA） —— //
+    QVector<int>    seatId;       // 稳定编号 seatKey(排, 列)（后端/消息使用）
+    QVector<float>  seatX, seatY; // 可见矩形左上角（已扣 seatGap）
+    QVector<qint16> seatCol, seatRow;
+    QVector<qint8>  seatZone;     // 所属书架分区 0..shelfCount-1
+    QSizeF          seatSize;     // 可见矩形尺寸（所有座位相同）
+    int             seatCols = 0, seatRows = 0;
+
+    // —— 走道 —— //
+    QVector<Span> aisleCols;      // 座位列之间的竖向走道（x 区间）
+    QVector<Span> aisleRows;      // 座位行之间的横向走道（y 区间）
+
+    int    seatCount() const { return seatX.size(); }
+    int    indexOf(int key) const;    // 稳定编号 → 本布局序号；本布局没排到该座位返回 -1
+    QRectF seatRect(int i) const { return QRectF(seatX.at(i), seatY.at(i), seatSize.width(), seatSize.height()); }
+    QRectF seatBounds() const;    // 全部座位的包围盒
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+#include <vector>
+
+class SeatLayout;
+
+// 座位空间索引：均匀网格分桶（桶边长≈座位步距），桶内座位以 CSR 连续存放。
+// 点查询 O(1)（一个桶里最多几张座位），矩形查询只访问被覆盖的桶。
+// 只在布局变化时重建；查询为 const，无内部可变状态。
+class SeatSpatialIndex {
+public:
+    void build(const SeatLayout& layout);
+    void clear();
+
+    bool isEmpty() const { return items_.empty(); }
+
+    // 点落在哪张座位上（按可见矩形），空白处返回 -1
+    int seatAt(const QPointF& p) const;
+
+    // 与矩形相交的所有座位（追加到 out，不重复）
+    void seatsIn(const QRectF& r, QVector<int>& out) const;
+
+private:
+    inline int bucketX(qreal x) const { return qBound(0, int((x - ox_) * invBucketW_), bw_ - 1); }
+    inline int bucketY(qreal y) const { return qBound(0, int((y - oy_) * invBucketH_), bh_ - 1); }
+    inline bool hit(int i, qreal x, qreal y) const {
+        return x >= x_[size_t(i)] && x < x_[size_t(i)] + w_ && y >= y_[size_t(i)] && y < y_[size_t(i)] + h_;
+    }
+
+    qreal ox_ = 0, oy_ = 0;                 // 索引原点（座位包围盒左上）
+    qreal invBucketW_ = 1, invBucketH_ = 1;
+    int   bw_ = 0, bh_ = 0;                 // 桶的列数/行数
+
+    std::vector<int>   start_;              // 桶 b 的座位位于 items_[start_[b], start_[b+1])
+    std::vector<int>   items_;
+    std::vector<float> x_, y_;              // 座位可见矩形（拷贝自布局，连续访问）
+    qreal w_ = 0, h_ = 0;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QPixmap>
+#include <QRectF>
+#include <QSize>
+#include <QSizeF>
+#include <seatui/student/seat_layout.hpp>
+
+// 座位精灵图集：每种座位状态只按当前座位尺寸与 DPR 光栅化一次，排成一条横向图集。
+// 绘制时用 QPainter::drawPixmapFragments 一次性贴出全部座位。
+// seatSize/radius 为屏幕逻辑尺寸（已乘视图缩放）；detailed=false 时省略描边（远景 LOD）。
+class SeatSpriteAtlas {
+public:
+    static constexpr qreal kPad = 2.0;     // 四周留白（逻辑像素），容纳描边与抗锯齿
+
+    void rebuild(const QSizeF& seatSize, qreal radius, qreal dpr, bool supersample, bool detailed = true);
+    bool matches(const QSizeF& seatSize, qreal radius, qreal dpr, bool supersample, bool detailed = true) const {
+        return !pixmap_.isNull() && seatSize == seatSize_ && qFuzzyCompare(radius, radius_)
+               && qFuzzyCompare(dpr, dpr_) && supersample == ss_ && detailed == detailed_;
+    }
+
+    const QPixmap& pixmap() const { return pixmap_; }
+    qreal dpr() const { return dpr_; }
+
+    // 某状态在图集中的源矩形（设备像素）
+    QRectF sourceRect(SeatState s) const {
+        return QRectF(int(s) * cellDev_.width(), 0, cellDev_.width(), cellDev_.height());
+    }
+
+private:
+    QPixmap pixmap_;
+    QSize   cellDev_;            // 单个精灵的设备像素尺寸
+    QSizeF  seatSize_;
+    qreal   radius_ = 0.0;
+    qreal   dpr_    = 1.0;
+    bool    ss_     = false;
+    bool    detailed_ = true;
+};
@@ -2,12 +2,19 @@
 #include <QMainWindow>
 #include <QTextEdit>
 #include <QtWebSockets/QWebSocket>
+#include <seatui/net/connection_manager.hpp>
 
 class QComboBox;
+class QLineEdit;
 class QPushButton;
 class QLabel;
 class QWidget;
 class QStackedWidget;
+class NavigationCanvas;
+class HeatmapView;
+class ImageIngest;
+class OutboundSpool;
+class MessageRouter;
 
 class StudentWindow : public QMainWindow {
     Q_OBJECT
@@ -22,6 +29,7 @@ private slots:
     // 导航页
     void onGenerate();   // 生成路径
     void onClear();      // 清除
+    void onTour();       // 多点路线
     // 侧边栏“返回登录”
     void onBackToLogin();
 
@@ -36,16 +44,19 @@ private:
     QPushButton *btnDash = nullptr, *btnNav = nullptr, *btnHeat = nullptr;
 
     // ===== 导航页控件 =====
-    QWidget*     navCanvas = nullptr;               // 地图画布占位（后续绘制路径）
+    NavigationCanvas* navCanvas = nullptr;          // 地图画布（网格/座位/路径）
     QComboBox*   destBox   = nullptr;               // 目标书架 A/B/C/D
     QPushButton* btnGen    = nullptr;               // 生成路径
     QPushButton* btnClear  = nullptr;               // 清除
+    QLineEdit*   tourEdit  = nullptr;               // 多点路线的书架，如 "ACD"
+    QPushButton* btnTour   = nullptr;               // 生成多点路线
     QLabel*      navStatus = nullptr;               // 状态提示
 
     // ===== 构建各页面 =====
     QWidget* buildDashboardPage();                  // 仪表盘主页
     QWidget* buildNavigationPage();                 // 导航页
-    QWidget* buildHeatmapPage();                    // 热力图占位页
+    QWidget* buildHeatmapPage();                    // 热力图页
+    HeatmapView* heatView = nullptr;                // 实时座位热力图
 
 
 
@@ -62,10 +73,14 @@ private:
     QPushButton *helpPickBtn_ = nullptr;
     QPushButton *helpSubmitBtn_ = nullptr;
     QPushButton *helpResetBtn_ = nullptr;
+    QLabel     *outboxLbl_ = nullptr;    // 发件箱积压提示
 
     QByteArray helpImgBytes_;    // PNG/JPEG 原始字节
     QString    helpImgFilename_; // 原始文件名
     QString    helpImgMime_;     // "image/png" ...
+    quint32    helpSeq_ = 0;     // 求助帧 requestId
+    ImageIngest* ingest_ = nullptr;   // 后台解码/预览/编码
+    quint64    helpImgGen_ = 0;  // 当前图片的处理代号（旧结果丢弃）
 
     // —— 一键求助：槽函数 —— //
     void onPickImage();
@@ -76,8 +91,15 @@ private:
 private:
     // —— WS 客户端 —— //
     void initWsClient();
-    void wsSend(const QByteArray& utf8Json);
-    QWebSocket* ws_ = nullptr;
+    // 求助帧先进发件箱（落盘），连上后按序发出；发件箱满时返回 false
+    bool wsSendBinary(const QByteArray& frame);
+    void updateOutboxLabel(int messages, qint64 bytes);
+    void updateConnLabel(ConnectionManager::State st);
+    ConnectionManager* conn_ = nullptr;               // 重连退避 / 心跳 / RTT
+    MessageRouter*     router_ = nullptr;             // 入站文本按 type 分发
+    QWebSocket* ws_ = nullptr;                         // = conn_->socket()
+    QLabel*     connLbl_ = nullptr;                    // 侧边栏连接状态
+    OutboundSpool* outbox_ = nullptr;
     bool wsReady_ = false;
 
 
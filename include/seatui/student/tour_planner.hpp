@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QVector>
+
+// 多点路线的访问顺序：从 0 号点（START）出发，经过其余全部点各一次，不要求回到起点。
+// 不超过 kExactLimit 个途经点时用 Held-Karp 动态规划求精确解（O(2^m · m²)）；
+// 更多时用最近邻构造 + 2-opt 改进。距离矩阵由调用方提供（NavRouter 缓存）。
+class TourPlanner {
+public:
+    static constexpr int     kExactLimit = 12;
+    static constexpr quint32 kInf = 0xFFFFFFFFu;
+
+    struct Tour {
+        QVector<int> order;        // 访问顺序（矩阵下标，不含 0 号起点）
+        quint64 cost  = 0;         // 总代价（10/14 格代价）
+        double  ms    = 0.0;       // 求解耗时
+        bool    exact = false;     // 是否为精确解
+        bool isValid() const { return !order.isEmpty(); }
+    };
+
+    // dist 为 n×n 行优先矩阵，dist[i*n+j] 为 i → j 的代价；任一点不可达返回空路线
+    static Tour solve(const QVector<quint32>& dist, int n);
+
+private:
+    static Tour heldKarp(const QVector<quint32>& dist, int n);
+    static Tour nearestNeighbour2Opt(const QVector<quint32>& dist, int n);
+    static quint64 pathCost(const QVector<quint32>& dist, int n, const QVector<int>& order);
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QImage>
+#include <QRect>
+#include <QSize>
+#include <QRectF>
+#include <QVector>
+#include <vector>
+
+class SeatLayout;
+
+// 热力图光栅化引擎：与 NavigationCanvas 网格对齐的浮点密度图（每格 kSub×kSub 像素）。
+// 流程：座位占用值铺到座位覆盖的像素 → 可分离高斯模糊（SSE2 四路并行，无 SSE2 时走标量）
+// → 预计算的 256 色查找表直接写入 QImage 扫描线。整层刷新目标 < 5 ms。
+//
+// 增量：模糊是线性的，单个座位变化 = 在模糊结果上加/减一个“盖章”
+// （座位方框与高斯核的卷积，可分离为两条一维剖面之积），只波及座位外扩 r 像素的范围；
+// 变化范围并入脏矩形，flush() 只重新着色脏矩形。
+class HeatmapEngine {
+public:
+    static constexpr int   kSub        = 4;     // 每格每边的密度像素数
+    static constexpr qreal kSigmaCells = 1.5;   // 高斯 σ（格）
+
+    // 按布局重建网格与座位覆盖范围；座位值清零
+    void setLayout(const SeatLayout& lay);
+
+    int   seatCount() const { return seatValue_.size(); }
+    // 0 空闲 … 1 占用；立即在模糊结果上盖章，返回本次波及的密度像素范围
+    QRect setSeatValue(int seat, float v);
+    float seatValue(int seat) const { return seatValue_.value(seat, 0.f); }
+
+    // 一次性替换全部座位值（下一次 flush 全量重算）
+    void setSeatValues(const QVector<float>& v);
+
+    // 全量刷新：累加 → 模糊 → 着色（布局变化后、或增量累计过多次后校正浮点误差）
+    void refresh();
+
+    // —— 回放：导出/载入模糊后的密度图 —— //
+    // 密度图按行存放，行跨度 densityStride()；载入 level>0 的降采样图时双线性放大
+    const std::vector<float>& density() const { return blur_; }
+    int   densityStride() const { return stride_; }
+    QSize densitySize() const { return QSize(w_, h_); }
+    QRect loadDensity(const std::vector<float>& grid, int gridStride, int level, const QVector<float>& seatValues);
+
+    // 把待着色的变化写入图像：需要全量时全量，否则只着色脏矩形；返回本次着色的像素范围
+    QRect flush();
+
+    bool   isDirty() const { return full_ || !dirty_.isEmpty(); }
+    QRect  dirtyRect() const { return full_ ? QRect(0, 0, w_, h_) : dirty_; }  // 密度像素
+    QRectF dirtyWorldRect() const { return toWorld(dirtyRect()); }
+    QRectF toWorld(const QRect& px) const;
+
+    const QImage& image() const { return image_; }
+    QRectF worldRect() const { return world_; } // 图像覆盖的世界坐标（= 网格区域）
+    double lastMs() const { return lastMs_; }
+
+private:
+    static constexpr int kResyncStamps = 4096;  // 增量盖章多少次后做一次全量校正
+
+    void buildKernel();
+    int  profile(int len, int keep = -1);      // 返回剖面槽位；淘汰时避开 keep
+    QRect stamp(int seat, float dv);
+    void buildLut();
+    void accumulate();
+    void blurRows(const float* src, float* dst) const;
+    void blurCols(const float* src, float* dst) const;
+    void colorize(const QRect& px);
+
+    int    w_ = 0, h_ = 0;          // 密度图尺寸（像素）
+    int    stride_ = 0;             // 行跨度（按 4 对齐，便于整组读写）
+    QRectF world_;
+
+    QVector<float> seatValue_;
+    QVector<QRect> seatPx_;         // 座位覆盖的密度像素范围
+
+    std::vector<float> kernel_;     // 归一化一维高斯，长度 2r+1
+    int   radius_ = 0;
+    float gain_   = 1.f;            // 单个满占用座位的峰值映射到色表顶端
+
+    std::vector<float> raw_, tmp_, blur_;
+    std::vector<float> prof_[2];    // 最近两种长度的盖章剖面（座位宽、高）
+    int   profLen_[2] = { -1, -1 };
+
+    bool  full_ = true;             // 需要全量刷新
+    QRect dirty_;                   // 待着色的密度像素范围
+    int   stamps_ = 0;
+    mutable std::vector<float> line_;
+    quint32 lut_[256] = {};
+    QImage  image_;
+    double  lastMs_ = 0.0;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <QWidget>
+#include <QHash>
+#include <QVector>
+#include <seatui/student/seat_layout.hpp>
+#include <seatui/widgets/heatmap_engine.hpp>
+
+// 热力图页面的绘制控件（学生端、管理端共用）：座位布局与 NavigationCanvas 同参数，
+// 按控件尺寸计算；座位实时状态进来后由 HeatmapEngine 增量盖章，
+// 绘制时只着色并重绘脏矩形，每秒数百次更新也只触及很小的区域。
+class HeatmapView : public QWidget {
+    Q_OBJECT
+public:
+    explicit HeatmapView(QWidget* parent = nullptr);
+
+    // 座位按稳定编号（SeatLayout::seatId，即消息里的 id，与 NavigationCanvas::setSeatState 一致）；
+    // 控件布局没排到的座位也记下，放大后生效
+    void setSeatState(int id, SeatState s);
+    SeatState seatState(int id) const { return SeatState(state_.value(id, quint8(SeatState::Free))); }
+    const QHash<int, quint8>& seatStates() const { return state_; }   // 非空闲座位
+    const SeatLayout& layout() const { return lay_; }
+
+    QRectF selectedArea() const { return selArea_; }   // 鼠标框选的区域（世界坐标），空为未选
+
+    // 回放：由外部（如 HeatmapTimeline）直接驱动引擎，再按返回的密度像素范围重绘
+    HeatmapEngine& engine() { return engine_; }
+    void repaintPixels(const QRect& px);
+
+signals:
+    void refreshed(double ms);           // 每次着色后报告耗时（增量时只含脏矩形）
+    void layoutChanged();                // 尺寸变化导致座位布局重建
+    void areaSelected(const QRectF& world);
+
+protected:
+    void paintEvent(QPaintEvent* e) override;
+    void resizeEvent(QResizeEvent* e) override;
+    void mousePressEvent(QMouseEvent* e) override;
+    void mouseMoveEvent(QMouseEvent* e) override;
+    void mouseReleaseEvent(QMouseEvent* e) override;
+
+private:
+    static float occupancyOf(SeatState s);
+
+    SeatLayout      lay_;
+    HeatmapEngine   engine_;
+    QHash<int, quint8> state_;           // 非空闲座位，按稳定编号；布局重建时按编号重新盖章
+
+    // 框选
+    QPointF selAnchor_;
+    QRectF  selArea_;
+    bool    selecting_ = false;
+};
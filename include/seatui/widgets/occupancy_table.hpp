@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QRect>
+#include <QRectF>
+#include <QVector>
+#include <vector>
+#include <seatui/student/seat_layout.hpp>
+
+// 一个矩形分区的占用统计
+struct ZoneOccupancy {
+    int seats = 0, occupied = 0, reserved = 0;
+    qreal rate() const { return seats > 0 ? qreal(occupied) / seats : 0.0; }
+};
+
+// 座位占用的二维前缀和（summed-area table）：座位网格 seatCols × seatRows，
+// 任意矩形分区的占用数/预约数 = 四次查表，O(1)。
+// 单个座位状态变化只需给其右下方的前缀和加减 1（座位网格很小，一层几百个座位）。
+class OccupancyTable {
+public:
+    void setLayout(const SeatLayout& lay);          // 按布局重建，座位全部空闲
+    bool setSeatState(int seat, SeatState s);       // 返回是否有变化
+
+    // 座位网格坐标（列, 行）的矩形分区
+    ZoneOccupancy query(const QRect& cells) const;
+    // 世界坐标的矩形（如框选区域）：座位中心落在其中的座位；行列换算为二分查找
+    ZoneOccupancy queryWorld(const QRectF& world) const;
+    ZoneOccupancy total() const { return query(QRect(0, 0, cols_, rows_)); }
+
+    // 书架分区 A/B/C/D 对应的座位列范围
+    int   zoneCount() const { return zones_.size(); }
+    QRect zoneCells(int zone) const { return zones_.value(zone); }
+
+private:
+    enum Plane { Occupied, Reserved, PlaneCount };
+    qint32 at(int plane, int x, int y) const { return sat_[plane][size_t(y) * (cols_ + 1) + x]; }
+    void   bump(int plane, int col, int row, int delta);
+
+    int cols_ = 0, rows_ = 0;
+    std::vector<qint32> sat_[PlaneCount];           // (cols+1)×(rows+1)，首行首列为 0
+    QVector<quint8>     state_;                     // 按座位序号
+    std::vector<float>  colX_, rowY_;               // 每列/每行座位中心（递增）
+    QVector<QRect>      zones_;
+};
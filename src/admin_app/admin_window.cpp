@@ -4,9 +4,11 @@
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QJsonDocument>
+#include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QDateTime>
+#include <QTimeZone>
 #include <QBuffer>
 #include <QImageReader>
 #include <QPushButton>
@@ -14,12 +16,22 @@
 #include <QScrollArea>
 #include <QPixmap>
 #include <QHBoxLayout>
+#include <QGridLayout>
+#include <QProgressBar>
+#include <QSlider>
+#include <QComboBox>
+#include <QTimer>
+#include <QThread>
+#include <QSignalBlocker>
 
 #include <seatui/widgets/card_dialog.hpp>   // 复用你已有卡片弹框样式
 #include <seatui/admin/admin_window.hpp>
+#include <seatui/widgets/heatmap_view.hpp>
+#include <seatui/net/help_packet.hpp>
+#include <seatui/admin/ws_server_worker.hpp>
+#include <seatui/admin/image_decode_service.hpp>
+#include <QPointer>
 
-#include <QtWebSockets/QWebSocketServer>
-#include <QtWebSockets/QWebSocket>
 
 AdminWindow::AdminWindow(QWidget* parent) : QMainWindow(parent) {
     setWindowTitle(u8"SeatUI 管理端");
@@ -34,13 +46,26 @@ AdminWindow::AdminWindow(QWidget* parent) : QMainWindow(parent) {
     tabs_->addTab(buildStatsPage(),     u8"统计");
     tabs_->addTab(buildTimelinePage(),  u8"时间轴");
 
+    // 求助图片后台解码：缩略图到了按行号填入
+    decoder_ = new ImageDecodeService(this);
+    connect(decoder_, &ImageDecodeService::thumbnailReady, this, [this](int key, const QImage& th){
+        QPointer<QLabel> lbl = thumbLbls_.take(key);
+        if (lbl && !th.isNull()) lbl->setPixmap(QPixmap::fromImage(th));
+    });
+
     initWsServer();
 }
 
 QWidget* AdminWindow::buildOverviewPage() {
     auto w = new QWidget(this);
     auto v = new QVBoxLayout(w);
-    auto t = new QLabel(u8"这里展示关键 KPI（占位）：\n• 当前占用率\n• 今日异常数\n• 最近 1h 求助…", w);
+    occRate_ = new QLabel(u8"当前占用率：—", w);
+    occRate_->setStyleSheet("font-size:22px; font-weight:600; color:#0f172a;");
+    v->addWidget(occRate_);
+    wsStat_ = new QLabel(w);
+    wsStat_->setStyleSheet("font-size:13px; color:#64748b;");
+    v->addWidget(wsStat_);
+    auto t = new QLabel(u8"这里展示关键 KPI（占位）：\n• 今日异常数\n• 最近 1h 求助…", w);
     t->setStyleSheet("font-size:15px; color:#334155;");
     v->addWidget(t);
     v->addStretch();
@@ -72,15 +97,44 @@ QWidget* AdminWindow::buildHelpCenterPage() {
 QWidget* AdminWindow::buildHeatmapPage() {
     auto w = new QWidget(this);
     auto v = new QVBoxLayout(w);
-    v->addWidget(new QLabel(u8"🔥 热力图占位（后续接入 QtCharts/自绘 QImage 叠加）", w));
-    v->addStretch();
+    v->addWidget(new QLabel(u8"🔥 实时座位热力图（自绘 QImage 叠加）", w));
+    heatView_ = new HeatmapView(w);
+    v->addWidget(heatView_, 1);
+    heatStat_ = new QLabel(u8"等待座位占用数据…（拖动鼠标可框选区域查看占用）", w);
+    heatStat_->setStyleSheet("color:#64748b;");
+    v->addWidget(heatStat_);
+
+    connect(heatView_, &HeatmapView::layoutChanged, this, &AdminWindow::syncOccupancyLayout);
+    connect(heatView_, &HeatmapView::areaSelected,  this, &AdminWindow::refreshOccupancyViews);
+    connect(heatView_, &HeatmapView::refreshed, this, [this](double ms){
+        if (heatView_->selectedArea().isEmpty())
+            heatStat_->setText(QString(u8"热力图刷新 %1 ms（拖动鼠标可框选区域查看占用）").arg(ms, 0, 'f', 2));
+    });
     return w;
 }
 
 QWidget* AdminWindow::buildStatsPage() {
     auto w = new QWidget(this);
     auto v = new QVBoxLayout(w);
-    v->addWidget(new QLabel(u8"📊 统计图占位（占用率/分区对比/小时聚合等）", w));
+    v->addWidget(new QLabel(u8"📊 分区对比（实时占用率）", w));
+
+    auto grid = new QGridLayout();
+    for (int i = 0; i < 4; ++i) {
+        auto name = new QLabel(QString(u8"%1 区").arg(QChar('A' + i)), w);
+        auto bar  = new QProgressBar(w);
+        bar->setRange(0, 1000);
+        bar->setTextVisible(false);
+        auto lbl  = new QLabel(u8"—", w);
+        lbl->setMinimumWidth(160);
+        grid->addWidget(name, i, 0);
+        grid->addWidget(bar,  i, 1);
+        grid->addWidget(lbl,  i, 2);
+        zoneBars_ << bar;
+        zoneLbls_ << lbl;
+    }
+    grid->setColumnStretch(1, 1);
+    v->addLayout(grid);
+    v->addWidget(new QLabel(u8"（小时聚合等后续接入）", w));
     v->addStretch();
     return w;
 }
@@ -88,15 +142,65 @@ QWidget* AdminWindow::buildStatsPage() {
 QWidget* AdminWindow::buildTimelinePage() {
     auto w = new QWidget(this);
     auto v = new QVBoxLayout(w);
-    v->addWidget(new QLabel(u8"⏱ 时间轴/事件回放占位", w));
-    v->addStretch();
+    v->addWidget(new QLabel(u8"⏱ 占用热力图回放", w));
+
+    replayView_ = new HeatmapView(w);
+    v->addWidget(replayView_, 1);
+
+    auto bar = new QHBoxLayout();
+    replayPlay_ = new QPushButton(u8"▶ 播放", w);
+    replaySpeed_ = new QComboBox(w);
+    replaySpeed_->addItem(u8"60×",   60);
+    replaySpeed_->addItem(u8"600×",  600);
+    replaySpeed_->addItem(u8"3600×", 3600);
+    replaySlider_ = new QSlider(Qt::Horizontal, w);
+    replaySlider_->setRange(0, 0);
+    bar->addWidget(replayPlay_);
+    bar->addWidget(replaySpeed_);
+    bar->addWidget(replaySlider_, 1);
+    v->addLayout(bar);
+
+    replayInfo_ = new QLabel(u8"暂无记录：收到座位占用数据后即可回放。", w);
+    replayInfo_->setStyleSheet("color:#64748b;");
+    v->addWidget(replayInfo_);
+
+    replayTimer_ = new QTimer(this);
+    replayTimer_->setInterval(16);
+    replayTimer_->setTimerType(Qt::PreciseTimer);
+    connect(replayTimer_, &QTimer::timeout, this, &AdminWindow::onReplayTick);
+
+    connect(replayPlay_, &QPushButton::clicked, this, [this]{
+        if (replayTimer_->isActive()) {
+            replayTimer_->stop();
+            replayPlay_->setText(u8"▶ 播放");
+            seekReplay(replayT_, 0);                  // 停下时换回逐事件的精确帧
+            return;
+        }
+        if (timeline_.isEmpty()) return;
+        if (replayT_ >= timeline_.endMs()) replayT_ = timeline_.startMs();
+        replayClock_.start();
+        replayTimer_->start();
+        replayPlay_->setText(u8"⏸ 暂停");
+    });
+    // 拖动时取粗层关键帧，松手后回到精确帧
+    connect(replaySlider_, &QSlider::sliderMoved, this, [this](int sec){
+        seekReplay(timeline_.startMs() + qint64(sec) * 1000, 1);
+    });
+    connect(replaySlider_, &QSlider::sliderReleased, this, [this]{
+        seekReplay(timeline_.startMs() + qint64(replaySlider_->value()) * 1000, 0);
+    });
+    connect(replayView_, &HeatmapView::layoutChanged, this, [this]{
+        timeline_.setLayout(replayView_->layout());
+        if (!timeline_.isEmpty()) seekReplay(replayT_, 0);
+    });
     return w;
 }
 
 void AdminWindow::appendHelpRow(const QString& when, const QString& user,
-                                const QString& text, const QPixmap& thumb,
-                                const QByteArray& rawImgBase64, const QString& mime)
+                                const QString& text,
+                                const QByteArray& imgOwner, QByteArrayView img, const QString& mime)
 {
+    const int key = ++helpRowSeq_;
     const int r = helpTable_->rowCount();
     helpTable_->insertRow(r);
 
@@ -105,10 +209,16 @@ void AdminWindow::appendHelpRow(const QString& when, const QString& user,
     auto *itemSumm = new QTableWidgetItem(text.left(48) + (text.size()>48?QStringLiteral("…"):QString()));
     auto *itemMime = new QTableWidgetItem(mime);
 
-    // 缩略图
+    // 缩略图：先放灰底占位，后台解码好再填入
     auto *thumbLbl = new QLabel();
-    thumbLbl->setPixmap(thumb.scaled(80, 50, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    QPixmap placeholder(ImageDecodeService::kThumbW, ImageDecodeService::kThumbH);
+    placeholder.fill(QColor(230,235,240));
+    thumbLbl->setPixmap(placeholder);
     thumbLbl->setAlignment(Qt::AlignCenter);
+    if (!img.isEmpty()) {
+        thumbLbls_.insert(key, thumbLbl);
+        decoder_->requestThumbnail(key, imgOwner, img);
+    }
 
     // 查看按钮
     auto *btn = new QPushButton(u8"查看");
@@ -131,12 +241,21 @@ void AdminWindow::appendHelpRow(const QString& when, const QString& user,
         info->setWordWrap(true);
         v->addWidget(info);
 
-        if (!rawImgBase64.isEmpty()) {
-            QByteArray imgBytes = QByteArray::fromBase64(rawImgBase64);
-            QPixmap px; px.loadFromData(imgBytes);
+        if (!img.isEmpty()) {
+            // 原图：缓存命中直接显示，否则后台解码，解码好时对话框还开着就填进去
             auto area = new QScrollArea(&dlg);
-            auto imgL = new QLabel();
-            imgL->setPixmap(px);
+            auto imgL = new QLabel(u8"正在加载原图…");
+            imgL->setAlignment(Qt::AlignCenter);
+            QImage full;
+            if (decoder_->requestFull(key, imgOwner, img, &full)) {
+                imgL->setPixmap(QPixmap::fromImage(full));
+            } else {
+                connect(decoder_, &ImageDecodeService::fullReady, imgL, [imgL, key](int k, const QImage& im){
+                    if (k != key) return;
+                    if (im.isNull()) imgL->setText(u8"原图无法解码。");
+                    else imgL->setPixmap(QPixmap::fromImage(im));
+                });
+            }
             area->setWidget(imgL);
             area->setWidgetResizable(true);
             area->setMinimumSize(640, 380);
@@ -152,61 +271,205 @@ void AdminWindow::appendHelpRow(const QString& when, const QString& user,
     });
 }
 
-void AdminWindow::onHelpArrived(const QByteArray& utf8Json) {
-    // 解析 JSON（兼容无图/无用户名）
-    QJsonParseError er; QJsonDocument d = QJsonDocument::fromJson(utf8Json, &er);
-    if (er.error != QJsonParseError::NoError || !d.isObject()) {
-        CardDialog(u8"解析失败", u8"收到的求助 JSON 无法解析。", this).exec();
+void AdminWindow::appendHelpFrame(const HelpPacket::View& v) {
+    const QString when = QDateTime::fromMSecsSinceEpoch(v.createdMs, QTimeZone::UTC).toString(Qt::ISODate);
+    const QString mime = v.mime.isEmpty() ? QStringLiteral("image/png") : QString::fromUtf8(v.mime);
+
+    appendHelpRow(when, v.user.isEmpty() ? QStringLiteral("student") : QString::fromUtf8(v.user),
+                  QString::fromUtf8(v.text), v.frame, v.image, mime);
+}
+
+void AdminWindow::onSeatOccupancy(const QJsonObject& o) {
+    if (!heatView_) return;
+    const QJsonArray seats = o.value("seats").toArray();
+    for (const QJsonValue& v : seats) {
+        const QJsonObject s = v.toObject();
+        const QString st = s.value("state").toString();
+        // 编号来自网络：先校验，越界的不进视图、前缀和表与时间轴
+        const int id = s.value("id").toInt(-1);
+        if (!SeatLayout::isValidKey(id)) continue;
+        const SeatState state = st == QLatin1String("occupied") ? SeatState::Occupied
+                              : st == QLatin1String("reserved") ? SeatState::Reserved
+                                                                : SeatState::Free;
+        if (heatView_->seatState(id) != state)
+            timeline_.record(QDateTime::currentMSecsSinceEpoch(), id, state);
+        heatView_->setSeatState(id, state);
+        occupancy_.setSeatState(heatView_->layout().indexOf(id), state);   // 前缀和表按本布局序号
+    }
+    refreshOccupancyViews();
+    refreshReplayRange();
+}
+
+void AdminWindow::refreshReplayRange() {
+    if (!replaySlider_ || timeline_.isEmpty()) return;
+    const QSignalBlocker block(replaySlider_);
+    replaySlider_->setRange(0, int((timeline_.endMs() - timeline_.startMs()) / 1000));
+    if (!replayTimer_->isActive() && replayT_ == 0) seekReplay(timeline_.endMs(), 0);
+}
+
+void AdminWindow::onReplayTick() {
+    const qreal speed = replaySpeed_->currentData().toReal();
+    replayT_ += qint64(replayClock_.restart() * speed);
+    if (replayT_ >= timeline_.endMs()) {
+        replayTimer_->stop();
+        replayPlay_->setText(u8"▶ 播放");
+        seekReplay(timeline_.endMs(), 0);
         return;
     }
-    const QJsonObject o = d.object();
-    if (o.value("type").toString() != "student_help") return;
-
-    const QString when = o.value("created_at").toString();
-    const QString user = o.value("user").toString("student");
-    const QString text = o.value("description").toString();
-
-    // 缩略图
-    QPixmap th; QByteArray rawB64; QString mime = "image/png";
-    if (o.contains("image") && o.value("image").isObject()) {
-        const QJsonObject im = o.value("image").toObject();
-        rawB64 = im.value("base64").toString().toLatin1();
-        mime   = im.value("mime").toString("image/png");
-        QByteArray bytes = QByteArray::fromBase64(rawB64);
-        th.loadFromData(bytes);
+    seekReplay(replayT_, HeatmapTimeline::levelForSpeed(speed));
+}
+
+void AdminWindow::seekReplay(qint64 t, int level) {
+    if (timeline_.isEmpty()) return;
+    replayT_ = qBound(timeline_.startMs(), t, timeline_.endMs());
+    QElapsedTimer clock; clock.start();
+    replayView_->repaintPixels(timeline_.seek(replayView_->engine(), replayT_, level));
+
+    if (!replaySlider_->isSliderDown()) {
+        const QSignalBlocker block(replaySlider_);
+        replaySlider_->setValue(int((replayT_ - timeline_.startMs()) / 1000));
     }
-    if (th.isNull()) th = QPixmap(80,50); // 无图给灰底
-    if (th.isNull()) th.fill(QColor(230,235,240));
+    replayInfo_->setText(QString(u8"%1 ｜ 层级 %2 ｜ 回放 %3 条事件，%4 ms ｜ 缓存 %5 MB")
+                             .arg(QDateTime::fromMSecsSinceEpoch(replayT_).toString("MM-dd HH:mm:ss"))
+                             .arg(level).arg(timeline_.lastReplayed())
+                             .arg(clock.nsecsElapsed() / 1e6, 0, 'f', 2)
+                             .arg(timeline_.cacheBytes() / 1048576.0, 0, 'f', 1));
+}
 
-    appendHelpRow(when, user, text, th, rawB64, mime);
+void AdminWindow::syncOccupancyLayout() {
+    // 座位布局随热力图控件尺寸重建：前缀和表跟着重建，并回放当前状态
+    const SeatLayout& lay = heatView_->layout();
+    occupancy_.setLayout(lay);
+    for (int i = 0; i < lay.seatCount(); ++i)
+        occupancy_.setSeatState(i, heatView_->seatState(lay.seatId.at(i)));
+    refreshOccupancyViews();
+}
+
+void AdminWindow::refreshOccupancyViews() {
+    // 每项都是常数次查表，可随每批数据或每帧调用
+    const ZoneOccupancy all = occupancy_.total();
+    if (occRate_)
+        occRate_->setText(QString(u8"当前占用率：%1%（%2 / %3 座，预约 %4）")
+                              .arg(all.rate() * 100, 0, 'f', 1).arg(all.occupied).arg(all.seats).arg(all.reserved));
+
+    for (int i = 0; i < zoneBars_.size(); ++i) {
+        const ZoneOccupancy z = occupancy_.query(occupancy_.zoneCells(i));
+        zoneBars_[i]->setValue(qRound(z.rate() * 1000));
+        zoneLbls_[i]->setText(QString(u8"%1 / %2 座（%3%）")
+                                  .arg(z.occupied).arg(z.seats).arg(z.rate() * 100, 0, 'f', 1));
+    }
+
+    if (heatStat_ && heatView_ && !heatView_->selectedArea().isEmpty()) {
+        const ZoneOccupancy a = occupancy_.queryWorld(heatView_->selectedArea());
+        heatStat_->setText(QString(u8"框选区域：%1 / %2 座占用（%3%），预约 %4")
+                               .arg(a.occupied).arg(a.seats).arg(a.rate() * 100, 0, 'f', 1).arg(a.reserved));
+    }
 }
 
 void AdminWindow::initWsServer() {
-    wsServer_ = new QWebSocketServer(QStringLiteral("SeatUI-Admin-WS"),
-                                     QWebSocketServer::NonSecureMode, this);
+    // 服务端与全部连接跑在专用网络线程；两边只通过 wsChannel_ 的无锁队列交换数据
+    wsChannel_ = std::make_shared<WsChannel>();
+    netThread_ = new QThread(this);
+    netThread_->setObjectName(QStringLiteral("seatui-ws"));
+    wsWorker_ = new WsServerWorker(wsChannel_);
+    wsWorker_->moveToThread(netThread_);
+    connect(netThread_, &QThread::finished, wsWorker_, &QObject::deleteLater);
+    netThread_->start();
+
+    // 有积压时每帧排空一次入站队列；空闲时定时器停着，worker 有新事件再叫醒。
+    // 要在 start 之前连好，否则最早的唤醒（如监听失败）会丢，inWake 再也清不掉
+    netTimer_ = new QTimer(this);
+    netTimer_->setTimerType(Qt::PreciseTimer);
+    netTimer_->setInterval(kNetFrameMs);
+    connect(netTimer_, &QTimer::timeout, this, &AdminWindow::drainNetwork);
+    connect(wsWorker_, &WsServerWorker::inboundReady, this, &AdminWindow::drainNetwork);   // 跨线程：排队投递
+
     const QHostAddress host = QHostAddress::LocalHost;  // 127.0.0.1
     const quint16 port = 12345;
-    if (!wsServer_->listen(host, port)) {
-        CardDialog(u8"WS 启动失败",
-                   u8"管理员端 WebSocket 服务器监听失败（127.0.0.1:12345）。", this).exec();
-        return;
+    WsServerWorker* w = wsWorker_;
+    QMetaObject::invokeMethod(w, [w, host, port]{ w->start(host, port); }, Qt::QueuedConnection);
+}
+
+AdminWindow::~AdminWindow() {
+    if (netThread_) {
+        netThread_->quit();
+        netThread_->wait();     // worker 及其套接字在线程退出时删除
     }
+}
 
-    connect(wsServer_, &QWebSocketServer::newConnection, this, [this]{
-        auto *sock = wsServer_->nextPendingConnection();
-        wsClients_ << sock;
-
-        // 学生端连上后可能先发一条 hello，这里统一接入 onHelpArrived
-        connect(sock, &QWebSocket::textMessageReceived, this, [this](const QString& msg){
-            onHelpArrived(msg.toUtf8());                 // 直接复用你现有解析与入表
-        });
-        connect(sock, &QWebSocket::disconnected, this, [this, sock]{
-            wsClients_.removeAll(sock);
-            sock->deleteLater();
-        });
-
-        // 可选：欢迎语
-        sock->sendTextMessage(QStringLiteral(R"({"type":"hello","role":"admin"})"));
-    });
+void AdminWindow::drainNetwork() {
+    // 先清标志再排空：排空期间 worker 新推的事件会再发一次 inboundReady，不会漏
+    wsChannel_->inWake.store(false, std::memory_order_release);
+    WsInbound e;
+    int n = 0;
+    for (; n < kNetEventsPerFrame && wsChannel_->in.pop(e); ++n) {
+        switch (e.kind) {
+        case WsInbound::ClientConnected:
+            sendSeatSnapshot(e.client);   // 新连接先拿到当前占用，不用等下一次变化
+            break;
+        case WsInbound::ClientDisconnected:
+            break;
+        case WsInbound::HelpJson:
+            appendHelpRow(e.when, e.user, e.text, e.bytes, QByteArrayView(e.bytes), e.mime);
+            break;
+        case WsInbound::HelpFrame:
+            appendHelpFrame(e.frame);
+            break;
+        case WsInbound::SeatOccupancy:
+            onSeatOccupancy(e.object);
+            break;
+        case WsInbound::Stats:
+            if (wsStat_) {
+                wsStat_->setText(QString(u8"WS 连接 %1 个 · 消息 %2 条，异常 %3 条")
+                                     .arg(e.clients).arg(e.messages).arg(e.errors));
+                wsStat_->setToolTip(e.text);
+            }
+            break;
+        case WsInbound::ListenFailed:
+            // 模态框的嵌套事件循环会再次进入 drainNetwork：推迟到本轮排空结束后再弹
+            qWarning("admin: ws listen failed: %s", qPrintable(e.text));
+            QTimer::singleShot(0, this, [this, err = e.text]{
+                CardDialog(u8"WS 启动失败",
+                           u8"管理员端 WebSocket 服务器监听失败（127.0.0.1:12345）。\n" + err, this).exec();
+            });
+            break;
+        case WsInbound::None:
+            break;
+        }
+    }
+    // 上一帧没推进去的出站消息
+    flushOutbound();
+
+    // 入站排到了底、出站也没有暂存：停下定时器，等下一次唤醒
+    const bool idle = n < kNetEventsPerFrame && outPending_.empty();
+    if (idle) netTimer_->stop();
+    else if (!netTimer_->isActive()) netTimer_->start();
 }
 
+void AdminWindow::sendText(quint64 client, const QByteArray& utf8) {
+    outPending_.push_back(WsOutbound{ client, utf8 });
+    flushOutbound();
+    if (!outPending_.empty() && !netTimer_->isActive()) netTimer_->start();   // 队列满：靠定时器重试
+}
+
+void AdminWindow::flushOutbound() {
+    bool pushed = false;
+    while (!outPending_.empty() && wsChannel_->out.push(std::move(outPending_.front()))) {
+        outPending_.pop_front();
+        pushed = true;
+    }
+    if (pushed) WsServerWorker::wake(wsWorker_, wsChannel_.get());
+}
+
+void AdminWindow::sendSeatSnapshot(quint64 client) {
+    if (!heatView_) return;
+    // 只记着非空闲座位，按稳定编号发出（含管理端窗口当前没排到的座位）
+    QJsonArray seats;
+    const QHash<int, quint8>& states = heatView_->seatStates();
+    for (auto it = states.constBegin(); it != states.constEnd(); ++it)
+        seats.append(QJsonObject{ { "id", it.key() },
+                                  { "state", SeatState(it.value()) == SeatState::Occupied ? "occupied" : "reserved" } });
+    if (seats.isEmpty()) return;
+    const QJsonObject o{ { "type", "seat_occupancy" }, { "seats", seats } };
+    sendText(client, QJsonDocument(o).toJson(QJsonDocument::Compact));
+}
@@ -0,0 +1,157 @@
+#include <seatui/admin/heatmap_timeline.hpp>
+#include <algorithm>
+
+HeatmapTimeline::HeatmapTimeline(){
+    grids_.setMaxCost(kMaxCacheBytes);
+}
+
+float HeatmapTimeline::occupancyOf(quint8 s){
+    return s == quint8(SeatState::Occupied) ? 1.f : s == quint8(SeatState::Reserved) ? 0.5f : 0.f;
+}
+
+void HeatmapTimeline::setLayout(const SeatLayout& lay){
+    lay_ = lay;
+    scratch_.setLayout(lay);
+    grids_.clear();
+    cursorEvent_ = -1;
+}
+
+void HeatmapTimeline::record(qint64 ms, int seat, SeatState s){
+    if (!SeatLayout::isValidKey(seat) || s == SeatState::Selected) return;
+    if (times_.empty()) {
+        t0_ = ms;
+        keys_ = { Key() };
+    }
+    ms = qMax(ms, endMs());
+
+    // 跨过关键帧边界：快照当前状态（之前的事件数 + 状态）
+    while (ms >= t0_ + qint64(keys_.size()) * kKeyIntervalMs)
+        keys_.push_back(Key{ int(times_.size()), live_ });
+
+    times_.push_back(ms);
+    seats_.push_back(seat);
+    states_.push_back(quint8(s));
+    if (seat >= live_.size()) live_.resize(seat + 1, quint8(SeatState::Free));   // 至多 kMaxSeats
+    live_[seat] = quint8(s);
+    trim();
+}
+
+void HeatmapTimeline::trim(){
+    // 丢掉前 segs 段后剩余的事件数与时长仍超限就再丢一段；最后一段（正在录入）总是保留
+    int segs = 0;
+    while (segs + 1 < keys_.size()
+           && (int(times_.size()) - keys_.at(segs).event > kMaxEvents
+               || endMs() - (t0_ + segs * kKeyIntervalMs) > kMaxSpanMs))
+        ++segs;
+    if (segs == 0) return;
+
+    // 第 segs 个关键帧成为新的起点：它的快照就是那一刻的完整状态
+    const int drop = keys_.at(segs).event;
+    times_.erase(times_.begin(), times_.begin() + drop);
+    seats_.erase(seats_.begin(), seats_.begin() + drop);
+    states_.erase(states_.begin(), states_.begin() + drop);
+    keys_.remove(0, segs);
+    for (Key& k : keys_) k.event -= drop;
+    t0_ += segs * kKeyIntervalMs;
+
+    grids_.clear();         // 缓存按关键帧下标取，下标整体平移后作废
+    cursorEvent_ = -1;
+}
+
+int HeatmapTimeline::levelForSpeed(qreal speed){
+    if (speed <= 120)  return 0;
+    if (speed <= 1200) return 1;
+    return kLevels - 1;
+}
+
+QVector<float> HeatmapTimeline::valuesAt(int key) const {
+    // 快照按稳定编号存，引擎按回放视图的布局序号取
+    const QVector<quint8>& st = keys_.at(key).states;
+    QVector<float> v(lay_.seatCount());
+    for (int i = 0; i < v.size(); ++i)
+        v[i] = occupancyOf(st.value(lay_.seatId.at(i), quint8(SeatState::Free)));
+    return v;
+}
+
+const HeatmapTimeline::Grid* HeatmapTimeline::grid(int level, int key){
+    const quint64 id = quint64(level) << 32 | quint32(key);
+    if (const Grid* g = grids_.object(id)) return g;
+
+    auto* g = new Grid;
+    if (level == 0) {
+        scratch_.setSeatValues(valuesAt(key));
+        scratch_.refresh();
+        g->data   = scratch_.density();
+        g->stride = scratch_.densityStride();
+    } else {
+        // 由第 0 层同一时刻的密度图做 2^level 盒式降采样
+        const Grid* base = grid(0, key);
+        if (!base) { delete g; return nullptr; }
+        const QSize sz = scratch_.densitySize();
+        const int f = 1 << level;
+        const int gw = (sz.width() + f - 1) / f, gh = (sz.height() + f - 1) / f;
+        g->stride = gw;
+        g->data.assign(size_t(gw) * gh, 0.f);
+        for (int y = 0; y < sz.height(); ++y) {
+            const float* in = base->data.data() + size_t(y) * base->stride;
+            float* out = g->data.data() + size_t(y / f) * gw;
+            for (int x = 0; x < sz.width(); ++x) out[x / f] += in[x];
+        }
+        const float inv = 1.f / float(f * f);
+        for (float& v : g->data) v *= inv;
+    }
+    const qint64 bytes = qint64(g->data.size() * sizeof(float));
+    grids_.insert(id, g, bytes);
+    return grids_.object(id);       // 超过总预算的单张图会被立即丢弃，返回空
+}
+
+QRect HeatmapTimeline::replay(HeatmapEngine& engine, int from, int to){
+    QRect dirty;
+    for (int i = from; i < to; ++i) {
+        const int seat = lay_.indexOf(seats_[size_t(i)]);
+        if (seat >= 0) dirty |= engine.setSeatValue(seat, occupancyOf(states_[size_t(i)]));
+    }
+    replayed_ += qMax(0, to - from);
+    return dirty;
+}
+
+QRect HeatmapTimeline::seek(HeatmapEngine& engine, qint64 t, int level){
+    replayed_ = 0;
+    if (times_.empty()) return QRect();
+    t = qBound(t0_, t, endMs());
+
+    // 目标时刻之前（含）的事件数
+    const int target = int(std::upper_bound(times_.begin(), times_.end(), t) - times_.begin());
+    const int key0   = qMin(int((t - t0_) / kKeyIntervalMs), keys_.size() - 1);
+
+    // 粗层：直接显示该层最近的关键帧，不回放
+    level = qBound(0, level, kLevels - 1);
+    if (level > 0) {
+        const int span = 1 << (2 * level);                 // 4^level 个第 0 层关键帧
+        const int key  = (key0 / span) * span;
+        if (const Grid* g = grid(level, key)) {
+            cursorEvent_ = -1;
+            return engine.loadDensity(g->data, g->stride, level, valuesAt(key));
+        }
+    }
+
+    // 顺序播放：游标在本段关键帧之后、目标之前，直接接着回放
+    if (cursorEvent_ >= keys_.at(key0).event && cursorEvent_ <= target) {
+        const QRect dirty = replay(engine, cursorEvent_, target);
+        cursorEvent_ = target;
+        return dirty;
+    }
+
+    // 否则从最近的关键帧载入，再回放到目标
+    QRect dirty;
+    if (const Grid* g = grid(0, key0)) {
+        dirty = engine.loadDensity(g->data, g->stride, 0, valuesAt(key0));
+        dirty |= replay(engine, keys_.at(key0).event, target);
+    } else {
+        engine.setSeatValues(valuesAt(key0));
+        replay(engine, keys_.at(key0).event, target);
+        dirty = QRect(QPoint(0, 0), engine.densitySize());
+    }
+    cursorEvent_ = target;
+    return dirty;
+}
@@ -0,0 +1,65 @@
+#include <seatui/admin/image_decode_service.hpp>
+#include <QBuffer>
+#include <QImageReader>
+#include <QThread>
+
+namespace {
+// 在不复制的前提下把视图包成 QIODevice 交给 QImageReader
+QImage decode(QByteArrayView bytes, const QSize& fit){
+    QByteArray raw = QByteArray::fromRawData(bytes.data(), bytes.size());
+    QBuffer buf(&raw);
+    buf.open(QIODevice::ReadOnly);
+    QImageReader reader(&buf);
+    reader.setAutoTransform(true);
+    if (fit.isValid()) {
+        const QSize full = reader.size();
+        if (full.isValid() && (full.width() > fit.width() || full.height() > fit.height()))
+            reader.setScaledSize(full.scaled(fit, Qt::KeepAspectRatio));
+    }
+    return reader.read();
+}
+}
+
+ImageDecodeService::ImageDecodeService(QObject* parent) : QObject(parent) {
+    pool_.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+    full_.setMaxCost(kMaxCacheBytes);
+}
+
+ImageDecodeService::~ImageDecodeService(){
+    pool_.clear();
+    pool_.waitForDone();
+}
+
+void ImageDecodeService::requestThumbnail(int key, const QByteArray& owner, QByteArrayView bytes){
+    pool_.start([this, key, owner, bytes]{
+        Q_UNUSED(owner);    // 捕获即持有
+        // 先按 2 倍尺寸快速解码，再平滑缩到目标大小，兼顾速度与观感
+        QImage img = decode(bytes, QSize(kThumbW * 2, kThumbH * 2));
+        if (!img.isNull())
+            img = img.scaled(kThumbW, kThumbH, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        QMetaObject::invokeMethod(this, [this, key, img]{
+            emit thumbnailReady(key, img);
+        }, Qt::QueuedConnection);
+    });
+}
+
+bool ImageDecodeService::requestFull(int key, const QByteArray& owner, QByteArrayView bytes, QImage* out){
+    if (const QImage* hit = full_.object(key)) {
+        *out = *hit;
+        return true;
+    }
+    if (pendingFull_.contains(key)) return false;
+    pendingFull_.insert(key);
+
+    // 原图优先于排队中的缩略图
+    pool_.start([this, key, owner, bytes]{
+        Q_UNUSED(owner);
+        const QImage img = decode(bytes, QSize());
+        QMetaObject::invokeMethod(this, [this, key, img]{
+            pendingFull_.remove(key);
+            if (!img.isNull()) full_.insert(key, new QImage(img), img.sizeInBytes());
+            emit fullReady(key, img);
+        }, Qt::QueuedConnection);
+    }, 1);
+    return false;
+}
@@ -0,0 +1,226 @@
+#include <seatui/admin/ws_server_worker.hpp>
+#include <seatui/net/message_router.hpp>
+#include <QJsonDocument>
+#include <QTimer>
+#include <QVariant>
+#include <QtWebSockets/QWebSocket>
+#include <QtWebSockets/QWebSocketServer>
+
+WsServerWorker::WsServerWorker(std::shared_ptr<WsChannel> ch, QObject* parent)
+    : QObject(parent), ch_(std::move(ch)) {}
+
+void WsServerWorker::start(const QHostAddress& host, quint16 port){
+    // 这些对象都以 this 为父对象，随 worker 留在网络线程
+    router_ = new MessageRouter(this);
+    initRoutes();
+
+    retry_ = new QTimer(this);
+    retry_->setSingleShot(true);
+    retry_->setInterval(kRetryMs);
+    connect(retry_, &QTimer::timeout, this, &WsServerWorker::flushPending);
+
+    auto stats = new QTimer(this);
+    connect(stats, &QTimer::timeout, this, &WsServerWorker::postStats);
+    stats->start(kStatsMs);
+
+    server_ = new QWebSocketServer(QStringLiteral("SeatUI-Admin-WS"), QWebSocketServer::NonSecureMode, this);
+    if (!server_->listen(host, port)) {
+        WsInbound e;
+        e.kind = WsInbound::ListenFailed;
+        e.text = server_->errorString();
+        post(std::move(e));
+        return;
+    }
+    connect(server_, &QWebSocketServer::newConnection, this, &WsServerWorker::onNewConnection);
+}
+
+void WsServerWorker::initRoutes(){
+    router_->on("hello", [](QWebSocket*, QByteArrayView){ return true; });
+
+    router_->on("student_help", [this](QWebSocket* from, QByteArrayView m){
+        const QByteArray bytes = m.toByteArray();
+        QJsonParseError er;
+        const QJsonDocument d = QJsonDocument::fromJson(bytes, &er);
+        if (er.error != QJsonParseError::NoError || !d.isObject()) return false;
+        // 带 requestId 的才去重（旧版客户端没有这个字段，无从判断是否重发）
+        const QJsonObject o = d.object();
+        if (o.contains("requestId")
+            && !firstHelp(o.value("user").toString().toUtf8(),
+                          QByteArray::number(o.value("requestId").toInteger()),
+                          o.value("created_at").toString().toUtf8()))
+            return true;
+        // 旧版 JSON：字段与 base64 图片都在这里解出，GUI 与二进制帧一样只管入表
+        WsInbound e;
+        e.kind = WsInbound::HelpJson;
+        e.when = o.value("created_at").toString();
+        e.user = o.value("user").toString(QStringLiteral("student"));
+        e.text = o.value("description").toString();
+        e.mime = QStringLiteral("image/png");
+        const QJsonValue im = o.value("image");
+        if (im.isObject()) {
+            e.bytes = QByteArray::fromBase64(im.toObject().value("base64").toString().toLatin1());
+            e.mime  = im.toObject().value("mime").toString(e.mime);
+        }
+        e.client = from ? from->property("wsClient").toULongLong() : 0;
+        post(std::move(e));
+        return true;
+    });
+
+    router_->on("seat_occupancy", [this](QWebSocket* from, QByteArrayView m){
+        const QJsonDocument d = QJsonDocument::fromJson(m.toByteArray());
+        if (!d.isObject()) return false;
+        // 转发给其他客户端（学生端导航与热力图）：就在网络线程做，不等 GUI
+        const QString msg = QString::fromUtf8(m);
+        for (QWebSocket* c : std::as_const(clients_))
+            if (c != from) c->sendTextMessage(msg);
+        WsInbound e;
+        e.kind   = WsInbound::SeatOccupancy;
+        e.client = from ? from->property("wsClient").toULongLong() : 0;
+        e.object = d.object();
+        post(std::move(e));
+        return true;
+    });
+
+    // 学生端发件箱把积压的小消息合成一帧：切出各条原文，按原顺序再分发。
+    // 只展开一层：条目本身是 batch 的直接拒收，坏客户端嵌套再深也不会递归。
+    // 带 seq 的帧处理完（内容坏了也一样）回 ack，学生端据此推进确认偏移
+    router_->on("batch", [this](QWebSocket* from, QByteArrayView m){
+        bool hasSeq = false;
+        const quint64 seq = MessageRouter::member(m, "seq").toULongLong(&hasSeq);
+        QVector<QByteArrayView> items;
+        bool ok = MessageRouter::items(MessageRouter::member(m, "items"), &items);
+        for (QByteArrayView item : std::as_const(items)) {
+            if (MessageRouter::peekType(item) == "batch") { ok = false; continue; }   // 整帧记一次 rejected
+            router_->dispatch(from, item);
+        }
+        if (hasSeq && from) acknowledge(from, seq);
+        return ok;
+    }, true);
+}
+
+void WsServerWorker::acknowledge(QWebSocket* sock, quint64 seq){
+    sock->setProperty("wsSeq", seq);
+    sock->sendTextMessage(QStringLiteral(R"({"type":"ack","seq":%1})").arg(seq));
+}
+
+bool WsServerWorker::firstHelp(const QByteArray& user, const QByteArray& requestId, const QByteArray& created){
+    // 断线重连后学生端从确认偏移重发，已入表的求助会再来一次；只记最近 kHelpDedup 条
+    const QByteArray key = user + '\x1f' + requestId + '\x1f' + created;
+    if (seenHelp_.contains(key)) return false;
+    seenHelp_.insert(key);
+    seenOrder_.push_back(key);
+    if (seenOrder_.size() > size_t(kHelpDedup)) {
+        seenHelp_.remove(seenOrder_.front());
+        seenOrder_.pop_front();
+    }
+    return true;
+}
+
+void WsServerWorker::onNewConnection(){
+    while (QWebSocket* sock = server_->nextPendingConnection()) {
+        const quint64 id = nextClient_++;
+        sock->setProperty("wsClient", id);
+        clients_.insert(id, sock);
+
+        connect(sock, &QWebSocket::textMessageReceived, this, [this, sock](const QString& msg){
+            router_->dispatch(sock, msg.toUtf8());
+        });
+        // 求助附件走二进制帧：在这里校验并定位各段，GUI 只管入表。
+        // 二进制帧不带序号，按顺序接在上一帧之后；坏帧也要确认，否则学生端会一直重发
+        connect(sock, &QWebSocket::binaryMessageReceived, this, [this, sock](const QByteArray& frame){
+            onHelpFrame(sock, frame);
+            acknowledge(sock, sock->property("wsSeq").toULongLong() + 1);
+        });
+        connect(sock, &QWebSocket::disconnected, this, [this, sock, id]{
+            clients_.remove(id);
+            sock->deleteLater();
+            WsInbound e;
+            e.kind    = WsInbound::ClientDisconnected;
+            e.client  = id;
+            e.clients = clients_.size();
+            post(std::move(e));
+        });
+
+        // 可选：欢迎语
+        sock->sendTextMessage(QStringLiteral(R"({"type":"hello","role":"admin"})"));
+
+        WsInbound e;
+        e.kind    = WsInbound::ClientConnected;
+        e.client  = id;
+        e.clients = clients_.size();
+        post(std::move(e));
+    }
+}
+
+void WsServerWorker::onHelpFrame(QWebSocket* sock, const QByteArray& frame){
+    WsInbound e;
+    if (!HelpPacket::isHelpFrame(frame)) {
+        router_->reportError(MessageRouter::Error::UnknownType, "binary",
+                             QStringLiteral("%1 bytes").arg(frame.size()));
+        return;
+    }
+    if (!HelpPacket::parse(frame, &e.frame)) {
+        router_->reportError(MessageRouter::Error::Malformed, "help_frame",
+                             QStringLiteral("%1 bytes").arg(frame.size()));
+        return;
+    }
+    if (!firstHelp(e.frame.user.toByteArray(), QByteArray::number(e.frame.requestId),
+                   QByteArray::number(e.frame.createdMs)))
+        return;
+    e.kind   = WsInbound::HelpFrame;
+    e.client = sock->property("wsClient").toULongLong();
+    post(std::move(e));
+}
+
+void WsServerWorker::post(WsInbound&& e){
+    // 有积压时新事件排在后面，保持顺序
+    if (pending_.empty() && ch_->in.push(std::move(e))) { wakeGui(); return; }
+    pending_.push_back(std::move(e));
+    if (!retry_->isActive()) retry_->start();
+}
+
+void WsServerWorker::flushPending(){
+    bool pushed = false;
+    while (!pending_.empty() && ch_->in.push(std::move(pending_.front()))) {
+        pending_.pop_front();
+        pushed = true;
+    }
+    if (pushed) wakeGui();
+    if (!pending_.empty()) retry_->start();
+}
+
+void WsServerWorker::wakeGui(){
+    if (ch_->inWake.exchange(true, std::memory_order_acq_rel)) return;   // GUI 还没排空上一次
+    emit inboundReady();
+}
+
+void WsServerWorker::wake(WsServerWorker* w, WsChannel* ch){
+    if (ch->outWake.exchange(true, std::memory_order_acq_rel)) return;   // 已有一次唤醒在路上
+    QMetaObject::invokeMethod(w, [w]{ w->drainOutbound(); }, Qt::QueuedConnection);
+}
+
+void WsServerWorker::drainOutbound(){
+    // 先清标志再排空：排空期间 GUI 新推的消息会再投递一次唤醒，不会漏
+    ch_->outWake.store(false, std::memory_order_release);
+    WsOutbound m;
+    while (ch_->out.pop(m)) {
+        const QString text = QString::fromUtf8(m.text);
+        if (m.client == 0) {
+            for (QWebSocket* c : std::as_const(clients_)) c->sendTextMessage(text);
+        } else if (QWebSocket* c = clients_.value(m.client)) {
+            c->sendTextMessage(text);
+        }
+    }
+}
+
+void WsServerWorker::postStats(){
+    WsInbound e;
+    e.kind     = WsInbound::Stats;
+    e.messages = router_->totalMessages();
+    e.errors   = router_->totalErrors();
+    e.clients  = clients_.size();
+    e.text     = router_->statsText()
+               + QStringLiteral("\nqueue in %1 / out %2, pending %3")
+                     .arg(ch_->in.sizeApprox()).arg(ch_->out.sizeApprox()).arg(pending_.size());
+    post(std::move(e));
+}
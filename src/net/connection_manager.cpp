@@ -0,0 +1,198 @@
+#include <seatui/net/connection_manager.hpp>
+#include <QRandomGenerator>
+#include <QtEndian>
+#include <QtWebSockets/QWebSocket>
+#include <algorithm>
+#include <cmath>
+
+/* ---------- RttHistogram ---------- */
+int RttHistogram::bucketOf(double ms){
+    if (ms < 1.0) return 0;
+    const int b = 1 + int(std::floor(std::log2(ms)));   // [1,2) → 1，[2,4) → 2 …
+    return std::min(b, kBuckets - 1);
+}
+
+QString RttHistogram::bucketLabel(int i){
+    if (i == 0)            return QStringLiteral("<1 ms");
+    if (i == kBuckets - 1) return QStringLiteral(">=%1 ms").arg(1 << (i - 1));
+    return QStringLiteral("%1-%2 ms").arg(1 << (i - 1)).arg(1 << i);
+}
+
+void RttHistogram::add(double ms){
+    if (n_ == kWindow) {                                // 窗口满：先淘汰最旧样本
+        const double old = ring_[head_];
+        --buckets_[bucketOf(old)];
+        sum_ -= old;
+    } else {
+        ++n_;
+    }
+    ring_[head_] = ms;
+    head_ = (head_ + 1) % kWindow;
+    ++buckets_[bucketOf(ms)];
+    sum_ += ms;
+}
+
+void RttHistogram::clear(){
+    buckets_.fill(0);
+    head_ = n_ = 0;
+    sum_ = 0.0;
+}
+
+double RttHistogram::percentile(double p) const {
+    if (n_ == 0) return 0.0;
+    std::array<double, kWindow> s;
+    const int start = (head_ + kWindow - n_) % kWindow;
+    for (int i = 0; i < n_; ++i) s[i] = ring_[(start + i) % kWindow];
+    const int k = qBound(0, int(std::ceil(p * n_)) - 1, n_ - 1);
+    std::nth_element(s.begin(), s.begin() + k, s.begin() + n_);
+    return s[k];
+}
+
+QString RttHistogram::summary() const {
+    if (n_ == 0) return QStringLiteral("RTT: no samples");
+    return QStringLiteral("RTT p50 %1 ms / p95 %2 ms / max %3 ms (n=%4)")
+        .arg(percentile(0.5), 0, 'f', 1)
+        .arg(percentile(0.95), 0, 'f', 1)
+        .arg(percentile(1.0), 0, 'f', 1)
+        .arg(n_);
+}
+
+QString RttHistogram::histogramText() const {
+    QString out = summary();
+    int peak = 1;
+    for (int c : buckets_) peak = std::max(peak, c);
+    for (int i = 0; i < kBuckets; ++i) {
+        if (buckets_[i] == 0) continue;
+        out += QStringLiteral("\n%1  %2 %3")
+                   .arg(bucketLabel(i), 10)
+                   .arg(QString(qMax(1, buckets_[i] * 20 / peak), QChar(0x2588)))
+                   .arg(buckets_[i]);
+    }
+    return out;
+}
+
+/* ---------- ConnectionManager ---------- */
+ConnectionManager::ConnectionManager(const QUrl& url, QObject* parent)
+    : QObject(parent), url_(url) {
+    ws_ = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
+    clock_.start();
+
+    reconnectTimer_.setSingleShot(true);
+    connect(&reconnectTimer_, &QTimer::timeout, this, &ConnectionManager::connectNow);
+    heartbeatTimer_.setInterval(kPingMs);
+    connect(&heartbeatTimer_, &QTimer::timeout, this, &ConnectionManager::onHeartbeat);
+
+    connect(ws_, &QWebSocket::connected, this, &ConnectionManager::onConnected);
+    connect(ws_, &QWebSocket::disconnected, this, &ConnectionManager::onDisconnected);
+    connect(ws_, QOverload<QAbstractSocket::SocketError>::of(&QWebSocket::errorOccurred),
+            this, [this](auto){ scheduleReconnect(); });
+    connect(ws_, &QWebSocket::pong, this, &ConnectionManager::onPong);
+
+    // 任何入站数据都说明对端还活着
+    auto seen = [this]{ lastSeenNs_ = clock_.nsecsElapsed(); };
+    connect(ws_, &QWebSocket::textMessageReceived, this, seen);
+    connect(ws_, &QWebSocket::binaryMessageReceived, this, seen);
+}
+
+void ConnectionManager::start(){
+    stopped_ = false;
+    attempt_ = 0;
+    reconnectTimer_.stop();
+    connectNow();
+}
+
+void ConnectionManager::stop(){
+    stopped_ = true;
+    reconnectTimer_.stop();
+    heartbeatTimer_.stop();
+    ws_->close();
+    setState(State::Idle);
+}
+
+qint64 ConnectionManager::retryInMs() const {
+    return state_ == State::Backoff ? qMax(0, reconnectTimer_.remainingTime()) : 0;
+}
+
+void ConnectionManager::connectNow(){
+    if (stopped_ || ws_->state() == QAbstractSocket::ConnectedState) return;
+    if (ws_->state() != QAbstractSocket::UnconnectedState) {
+        opening_ = true;                                // 残留的半开连接：丢掉，别再排一次重连
+        ws_->abort();
+        opening_ = false;
+    }
+    connectStartNs_ = clock_.nsecsElapsed();
+    setState(State::Connecting);
+    heartbeatTimer_.start();                            // 连接阶段用来检查握手超时
+    ws_->open(url_);
+}
+
+void ConnectionManager::scheduleReconnect(){
+    // 同一次失败常常 errorOccurred 与 disconnected 都会来：定时器已在跑就不再排
+    if (stopped_ || opening_ || reconnectTimer_.isActive()) return;
+    if (ws_->state() == QAbstractSocket::ConnectedState) return;
+    heartbeatTimer_.stop();
+
+    const int exp   = std::min(attempt_, 16);
+    const int cap   = int(std::min<qint64>(kMaxDelayMs, qint64(kBaseDelayMs) << exp));
+    const int delay = kMinDelayMs + int(QRandomGenerator::global()->bounded(quint32(qMax(1, cap - kMinDelayMs))));
+    ++attempt_;
+
+    reconnectTimer_.start(delay);
+    setState(State::Backoff);
+    qInfo("ws: reconnect #%d in %d ms; %s", attempt_, delay, qPrintable(rtt_.summary()));
+    emit reconnectScheduled(delay, attempt_);
+}
+
+void ConnectionManager::onConnected(){
+    attempt_ = 0;
+    reconnectTimer_.stop();
+    lastSeenNs_ = clock_.nsecsElapsed();
+    heartbeatTimer_.start();
+    setState(State::Connected);
+    onHeartbeat();                                      // 立刻取一个 RTT 样本
+}
+
+void ConnectionManager::onDisconnected(){
+    if (state_ == State::Connected)
+        qInfo("ws: disconnected; %s", qPrintable(rtt_.summary()));
+    scheduleReconnect();
+}
+
+void ConnectionManager::onHeartbeat(){
+    const qint64 now = clock_.nsecsElapsed();
+    if (state_ == State::Connecting) {
+        if (now - connectStartNs_ > qint64(kConnectTimeoutMs) * 1000000) {
+            qInfo("ws: handshake timed out");
+            ws_->abort();
+            scheduleReconnect();                        // TCP 未建立时 abort 不一定发 disconnected
+        }
+        return;
+    }
+    if (state_ != State::Connected) return;
+    if (now - lastSeenNs_ > qint64(kDeadMs) * 1000000) {
+        qInfo("ws: no traffic for %d ms, dropping connection", kDeadMs);
+        ws_->abort();
+        scheduleReconnect();
+        return;
+    }
+    QByteArray payload(8, Qt::Uninitialized);
+    qToLittleEndian<qint64>(now, payload.data());
+    ws_->ping(payload);
+}
+
+void ConnectionManager::onPong(quint64 elapsedMs, const QByteArray& payload){
+    const qint64 now = clock_.nsecsElapsed();
+    lastSeenNs_ = now;
+    // 自带的 elapsedTime 只有毫秒精度；载荷里是发送时刻，纳秒精度
+    const double ms = payload.size() == 8
+        ? (now - qFromLittleEndian<qint64>(payload.constData())) / 1e6
+        : double(elapsedMs);
+    rtt_.add(ms);
+    emit rttSampled(ms);
+}
+
+void ConnectionManager::setState(State s){
+    if (state_ == s) return;
+    state_ = s;
+    emit stateChanged(s);
+}
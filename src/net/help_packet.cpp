@@ -0,0 +1,72 @@
+#include <seatui/net/help_packet.hpp>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+constexpr char kMagic[4] = { 'S', 'U', 'H', 'P' };
+
+template <class T>
+inline void put(char* at, T v){ qToLittleEndian<T>(v, at); }
+
+template <class T>
+inline T get(const char* at){ return qFromLittleEndian<T>(at); }
+}
+
+QByteArray HelpPacket::encode() const {
+    // 短字段长度为 16 位，超长的截断（用户名/MIME/文件名正常都很短）
+    const QByteArray u = user.toUtf8().left(0xFFFF), m = mime.toUtf8().left(0xFFFF);
+    const QByteArray n = filename.toUtf8().left(0xFFFF), t = text.toUtf8();
+    const qsizetype total = kHeaderSize + u.size() + m.size() + n.size() + t.size() + image.size();
+
+    QByteArray out(total, Qt::Uninitialized);
+    char* p = out.data();
+    std::memcpy(p, kMagic, 4);
+    p[4] = char(kVersion);
+    p[5] = char(kTypeHelp);
+    put<quint16>(p + 6,  0);
+    put<quint32>(p + 8,  requestId);
+    put<qint64> (p + 12, createdMs);
+    put<quint16>(p + 20, quint16(u.size()));
+    put<quint16>(p + 22, quint16(m.size()));
+    put<quint16>(p + 24, quint16(n.size()));
+    put<quint16>(p + 26, 0);
+    put<quint32>(p + 28, quint32(t.size()));
+    put<quint32>(p + 32, quint32(image.size()));
+
+    p += kHeaderSize;
+    for (const QByteArray* part : { &u, &m, &n, &t, &image }) {
+        std::memcpy(p, part->constData(), size_t(part->size()));
+        p += part->size();
+    }
+    return out;
+}
+
+bool HelpPacket::isHelpFrame(const QByteArray& frame){
+    return frame.size() >= kHeaderSize && std::memcmp(frame.constData(), kMagic, 4) == 0
+        && quint8(frame.at(5)) == kTypeHelp;
+}
+
+bool HelpPacket::parse(const QByteArray& frame, View* out){
+    if (!isHelpFrame(frame) || quint8(frame.at(4)) != kVersion) return false;
+
+    const char* p = frame.constData();
+    const qsizetype lens[5] = {
+        get<quint16>(p + 20), get<quint16>(p + 22), get<quint16>(p + 24),
+        get<quint32>(p + 28), get<quint32>(p + 32),
+    };
+    qsizetype need = kHeaderSize;
+    for (qsizetype l : lens) need += l;
+    if (need != frame.size()) return false;
+
+    out->frame     = frame;              // 共享，不复制
+    out->requestId = get<quint32>(p + 8);
+    out->createdMs = get<qint64>(p + 12);
+
+    const char* at = out->frame.constData() + kHeaderSize;
+    QByteArrayView* parts[5] = { &out->user, &out->mime, &out->filename, &out->text, &out->image };
+    for (int i = 0; i < 5; ++i) {
+        *parts[i] = QByteArrayView(at, lens[i]);
+        at += lens[i];
+    }
+    return true;
+}
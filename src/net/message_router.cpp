@@ -0,0 +1,185 @@
+#include <seatui/net/message_router.hpp>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <algorithm>
+
+namespace {
+inline const char* skipWs(const char* p, const char* e){
+    while (p < e && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+    return p;
+}
+
+// p 指向开引号；返回闭引号之后，未闭合返回 nullptr
+const char* skipString(const char* p, const char* e){
+    for (++p; p < e; ++p) {
+        if (*p == '\\') { ++p; continue; }
+        if (*p == '"') return p + 1;
+    }
+    return nullptr;
+}
+
+// 跳过一个值（字符串 / 对象 / 数组 / 标量）；返回值之后，非法返回 nullptr
+const char* skipValue(const char* p, const char* e){
+    p = skipWs(p, e);
+    if (p >= e) return nullptr;
+    if (*p == '"') return skipString(p, e);
+    if (*p == '{' || *p == '[') {
+        int depth = 0;
+        while (p < e) {
+            const char c = *p;
+            if (c == '"') {
+                p = skipString(p, e);
+                if (!p) return nullptr;
+                continue;
+            }
+            if (c == '{' || c == '[') ++depth;
+            else if ((c == '}' || c == ']') && --depth == 0) return p + 1;
+            ++p;
+        }
+        return nullptr;
+    }
+    const char* s = p;
+    while (p < e && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t') ++p;
+    return p > s ? p : nullptr;
+}
+
+// 每种错误只在第 1、2、4、8… 次打日志，坏客户端刷屏时日志量是对数级
+inline bool shouldLog(quint64 n){ return (n & (n - 1)) == 0; }
+
+const char* errorName(MessageRouter::Error e){
+    switch (e) {
+    case MessageRouter::Error::Malformed:   return "malformed";
+    case MessageRouter::Error::UnknownType: return "unknown type";
+    case MessageRouter::Error::Rejected:    return "rejected";
+    }
+    return "?";
+}
+}
+
+MessageRouter::MessageRouter(QObject* parent) : QObject(parent) {}
+
+void MessageRouter::on(const QByteArray& type, Handler h, bool container){
+    Route& r = routes_[type];
+    r.handler   = std::move(h);
+    r.container = container;
+}
+
+bool MessageRouter::dispatch(QWebSocket* from, QByteArrayView msg){
+    const QByteArrayView type = peekType(msg);
+    if (type.isEmpty()) {
+        ++messages_;
+        reportError(Error::Malformed, {}, QString::fromUtf8(msg.left(64)));
+        return false;
+    }
+    // fromRawData 不复制，只为了能用 QByteArray 作键查表
+    const auto it = routes_.find(QByteArray::fromRawData(type.data(), type.size()));
+    if (it == routes_.end()) {
+        ++messages_;
+        reportError(Error::UnknownType, type);
+        return false;
+    }
+    if (!it->container) ++messages_;               // 外壳里的各条会各自计数
+
+    QElapsedTimer t; t.start();
+    const bool ok = it->handler(from, msg);        // batch 的耗时包含其中各条
+    const double ms = t.nsecsElapsed() / 1e6;
+
+    TypeStats& s = it->stats;
+    ++s.count;
+    s.totalMs += ms;
+    s.maxMs = std::max(s.maxMs, ms);
+    s.latency.add(ms);
+    if (!ok) {
+        ++s.errors;
+        reportError(Error::Rejected, type);
+    }
+    return ok;
+}
+
+void MessageRouter::reportError(Error e, QByteArrayView type, const QString& detail){
+    const quint64 n = ++errors_[int(e)];
+    const QString t = QString::fromUtf8(type);
+    if (shouldLog(n))
+        qWarning("ws: %s message (type \"%s\", #%llu) %s", errorName(e), qPrintable(t),
+                 static_cast<unsigned long long>(n), qPrintable(detail));
+    emit errorCounted(e, t, detail);
+}
+
+quint64 MessageRouter::totalErrors() const {
+    quint64 n = 0;
+    for (quint64 c : errors_) n += c;
+    return n;
+}
+
+const MessageRouter::TypeStats* MessageRouter::stats(const QByteArray& type) const {
+    const auto it = routes_.constFind(type);
+    return it == routes_.constEnd() ? nullptr : &it->stats;
+}
+
+QString MessageRouter::statsText() const {
+    QStringList lines;
+    lines << QStringLiteral("messages %1, malformed %2, unknown type %3, rejected %4")
+                 .arg(messages_).arg(errors_[0]).arg(errors_[1]).arg(errors_[2]);
+    QList<QByteArray> types = routes_.keys();
+    std::sort(types.begin(), types.end());
+    for (const QByteArray& type : std::as_const(types)) {
+        const TypeStats& s = routes_.value(type).stats;
+        if (s.count == 0) continue;
+        lines << QStringLiteral("%1  n=%2 err=%3  avg %4 ms / p95 %5 ms / max %6 ms")
+                     .arg(QString::fromUtf8(type), -16)
+                     .arg(s.count).arg(s.errors)
+                     .arg(s.totalMs / s.count, 0, 'f', 3)
+                     .arg(s.latency.percentile(0.95), 0, 'f', 3)
+                     .arg(s.maxMs, 0, 'f', 3);
+    }
+    return lines.join('\n');
+}
+
+/* ---------- 扫描 ---------- */
+QByteArrayView MessageRouter::member(QByteArrayView json, QByteArrayView key){
+    const char* e = json.data() + json.size();
+    const char* p = skipWs(json.data(), e);
+    if (p >= e || *p != '{') return {};
+    p = skipWs(p + 1, e);
+    while (p < e && *p == '"') {
+        const char* k = p + 1;
+        const char* q = skipString(p, e);
+        if (!q) return {};
+        const QByteArrayView name(k, q - 1 - k);
+        p = skipWs(q, e);
+        if (p >= e || *p != ':') return {};
+        const char* v = skipWs(p + 1, e);
+        const char* ve = skipValue(v, e);
+        if (!ve) return {};
+        if (name == key) return QByteArrayView(v, ve - v);
+        p = skipWs(ve, e);
+        if (p >= e || *p != ',') return {};
+        p = skipWs(p + 1, e);
+    }
+    return {};
+}
+
+QByteArrayView MessageRouter::peekType(QByteArrayView json){
+    const QByteArrayView v = member(json, "type");
+    if (v.size() < 2 || v.front() != '"' || v.back() != '"') return {};
+    return v.sliced(1, v.size() - 2);
+}
+
+bool MessageRouter::items(QByteArrayView array, QVector<QByteArrayView>* out){
+    out->clear();
+    const char* e = array.data() + array.size();
+    const char* p = skipWs(array.data(), e);
+    if (p >= e || *p != '[') return false;
+    p = skipWs(p + 1, e);
+    if (p < e && *p == ']') return true;
+    while (p < e) {
+        const char* ve = skipValue(p, e);
+        if (!ve) return false;
+        out->append(QByteArrayView(p, ve - p));
+        p = skipWs(ve, e);
+        if (p < e && *p == ']') return true;
+        if (p >= e || *p != ',') return false;
+        p = skipWs(p + 1, e);
+    }
+    return false;
+}
@@ -0,0 +1,266 @@
+#include <seatui/net/outbound_spool.hpp>
+#include <QDir>
+#include <QSaveFile>
+#include <QtEndian>
+#include <QtWebSockets/QWebSocket>
+
+#if defined(Q_OS_WIN)
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace {
+constexpr int kHeader = 8;
+
+// flush 只把 QFile 缓冲交给内核，fsync 才保证落到磁盘
+bool syncFile(QFile& f){
+    if (!f.flush()) return false;
+#if defined(Q_OS_WIN)
+    return ::_commit(f.handle()) == 0;
+#else
+    return ::fsync(f.handle()) == 0;
+#endif
+}
+
+// 读一条记录；长度越界、kind 非法或 CRC 不符返回 false
+bool readRecord(QFile& f, qint64 limit, OutboundSpool::Kind* kind, QByteArray* payload){
+    char h[kHeader];
+    if (f.pos() + kHeader > limit || f.read(h, kHeader) != kHeader) return false;
+    const qint64 len = qFromLittleEndian<quint32>(h);
+    if (quint8(h[4]) > quint8(OutboundSpool::Kind::Binary) || f.pos() + len > limit) return false;
+    *payload = f.read(len);
+    if (payload->size() != len) return false;
+    if (qChecksum(*payload) != qFromLittleEndian<quint16>(h + 6)) return false;
+    *kind = OutboundSpool::Kind(quint8(h[4]));
+    return true;
+}
+}
+
+OutboundSpool::OutboundSpool(const QString& dir, QObject* parent)
+    : QObject(parent), dir_(dir) {
+    syncTimer_.setSingleShot(true);
+    syncTimer_.setInterval(kSyncMs);
+    connect(&syncTimer_, &QTimer::timeout, this, &OutboundSpool::sync);
+    drainTimer_.setInterval(kDrainMs);
+    connect(&drainTimer_, &QTimer::timeout, this, &OutboundSpool::drain);
+
+    if (!open()) qWarning("OutboundSpool: cannot open %s", qPrintable(dir_));
+}
+
+OutboundSpool::~OutboundSpool(){
+    if (!isOpen()) return;
+    sync();
+    saveAck();
+}
+
+bool OutboundSpool::open(){
+    QDir().mkpath(dir_);
+    writer_.setFileName(dir_ + QStringLiteral("/outbox.spool"));
+    reader_.setFileName(writer_.fileName());
+    ack_.setFileName(dir_ + QStringLiteral("/outbox.ack"));
+    if (!writer_.open(QIODevice::ReadWrite) || !reader_.open(QIODevice::ReadOnly)
+        || !ack_.open(QIODevice::ReadWrite)) {
+        writer_.close(); reader_.close(); ack_.close();
+        return false;
+    }
+    recover();
+    return true;
+}
+
+void OutboundSpool::recover(){
+    const qint64 size = writer_.size();
+    acked_ = 0;
+    const QByteArray a = ack_.readAll();
+    if (a.size() == 8) acked_ = qFromLittleEndian<qint64>(a.constData());
+    if (acked_ < 0 || acked_ > size) acked_ = 0;     // 压缩中途退出：从头重发（至少一次）
+
+    // 从确认偏移扫到尾部：数出待发记录，截掉崩溃留下的半截记录
+    count_ = 0;
+    reader_.seek(acked_);
+    Kind kind; QByteArray payload;
+    qint64 pos = acked_;
+    while (readRecord(reader_, size, &kind, &payload)) {
+        pos = reader_.pos();
+        ++count_;
+    }
+    if (pos < size) writer_.resize(pos);
+
+    end_ = synced_ = pos;
+    sent_ = acked_;
+    writer_.seek(end_);
+}
+
+void OutboundSpool::attach(QWebSocket* ws){
+    ws_ = ws;
+    connect(ws, &QWebSocket::connected, &drainTimer_, qOverload<>(&QTimer::start));
+    connect(ws, &QWebSocket::disconnected, this, &OutboundSpool::rewind);
+    if (ws->state() == QAbstractSocket::ConnectedState) drainTimer_.start();
+}
+
+bool OutboundSpool::enqueue(Kind kind, const QByteArray& payload){
+    if (!isOpen()) return false;
+    const qint64 rec = kHeader + payload.size();
+    if (count_ >= kMaxSpoolCount || pendingBytes() + rec > kMaxSpoolBytes) return false;
+
+    char h[kHeader];
+    qToLittleEndian<quint32>(quint32(payload.size()), h);
+    h[4] = char(kind);
+    h[5] = 0;
+    qToLittleEndian<quint16>(qChecksum(payload), h + 6);
+    if (writer_.write(h, kHeader) != kHeader || writer_.write(payload) != payload.size()) {
+        // 写了一半：退回到上一条记录的结尾
+        writer_.flush();
+        writer_.resize(end_);
+        writer_.seek(end_);
+        return false;
+    }
+    end_ += rec;
+    ++count_;
+
+    if (!syncTimer_.isActive()) syncTimer_.start();
+    if (ws_ && ws_->state() == QAbstractSocket::ConnectedState && !drainTimer_.isActive())
+        drainTimer_.start();
+    emit backlogChanged(count_, pendingBytes());
+    return true;
+}
+
+void OutboundSpool::sendNow(const QString& text){
+    if (ws_) ws_->sendTextMessage(text);
+}
+
+void OutboundSpool::sync(){
+    syncTimer_.stop();
+    if (synced_ == end_) return;
+    if (syncFile(writer_)) synced_ = end_;
+}
+
+void OutboundSpool::drain(){
+    if (!ws_ || ws_->state() != QAbstractSocket::ConnectedState || sent_ == end_) {
+        drainTimer_.stop();
+        return;
+    }
+    if (inFlight_ >= kMaxInFlight) return;       // 背压：等管理端确认
+    if (flights_.isEmpty() && acked_ >= kCompactBytes) compact();
+    if (synced_ < end_) sync();                   // 先落盘再发送；读端也要看到缓冲里的记录
+
+    reader_.seek(sent_);
+    QByteArray batch;
+    int    batched = 0;
+    qint64 batchEnd = sent_;
+    auto flushBatch = [&]{
+        if (batched == 0) return;
+        const quint64 seq = ++seq_;
+        sendFrame(false, QByteArrayLiteral("{\"type\":\"batch\",\"seq\":") + QByteArray::number(seq)
+                             + QByteArrayLiteral(",\"items\":[") + batch + QByteArrayLiteral("]}"),
+                  batchEnd, batched, seq);
+        batch.clear();
+        batched = 0;
+    };
+
+    qint64 budget = kBatchBytes;
+    Kind kind; QByteArray payload;
+    while (budget > 0 && inFlight_ < kMaxInFlight && readRecord(reader_, end_, &kind, &payload)) {
+        const qint64 pos = reader_.pos();
+        budget -= kHeader + payload.size();
+        if (kind == Kind::Text) {
+            if (batched) batch += ',';
+            batch += payload;
+            ++batched;
+            batchEnd = pos;
+            if (payload.size() <= kSmallText) continue;
+            flushBatch();                          // 大文本不与后面的合批
+            continue;
+        }
+        flushBatch();                              // 保持顺序：先发已攒的文本
+        sendFrame(true, payload, pos, 1, ++seq_);
+    }
+    flushBatch();
+}
+
+void OutboundSpool::sendFrame(bool binary, const QByteArray& payload, qint64 end, int records, quint64 seq){
+    if (binary) ws_->sendBinaryMessage(payload);
+    else        ws_->sendTextMessage(QString::fromUtf8(payload));
+    flights_.push_back(Flight{ seq, end, payload.size(), records });
+    inFlight_ += payload.size();
+    sent_ = end;
+}
+
+void OutboundSpool::acknowledge(quint64 seq){
+    // 确认是累积的：seq 及之前的帧都已处理；重复或过期的确认不起作用，
+    // 超出本连接已发序号的（上一连接残留或对端出错）也不认
+    if (seq > seq_) return;
+    bool acked = false;
+    while (!flights_.isEmpty() && flights_.front().seq <= seq) {
+        const Flight f = flights_.takeFirst();
+        inFlight_ -= f.bytes;
+        acked_  = f.end;
+        count_ -= f.records;
+        acked   = true;
+    }
+    if (!acked) return;
+    saveAck();
+    emit backlogChanged(count_, pendingBytes());
+    if (flights_.isEmpty() && sent_ == end_) compact();
+}
+
+void OutboundSpool::rewind(){
+    // 断线：未确认的帧可能没送到或没处理，从确认偏移重发；帧序号随新连接重新计
+    drainTimer_.stop();
+    flights_.clear();
+    inFlight_ = 0;
+    seq_ = 0;
+    sent_ = acked_;
+}
+
+void OutboundSpool::compact(){
+    if (!isOpen() || !flights_.isEmpty() || acked_ == 0) return;
+    if (acked_ == end_) {
+        // 全部送达：清空文件（先截断再清确认偏移，中途退出时确认偏移越界会被当成 0）
+        sync();
+        writer_.resize(0);
+        writer_.seek(0);
+        acked_ = sent_ = end_ = synced_ = 0;
+        saveAck();
+        return;
+    }
+    if (acked_ < kCompactBytes) return;
+
+    // 长时间积压、一直排不空：把未确认的尾部搬到新文件，已确认部分不再占盘
+    sync();
+    QSaveFile out(writer_.fileName());
+    if (!out.open(QIODevice::WriteOnly)) return;
+    reader_.seek(acked_);
+    for (qint64 left = end_ - acked_; left > 0; ) {
+        const QByteArray chunk = reader_.read(qMin<qint64>(left, kBatchBytes));
+        if (chunk.isEmpty() || out.write(chunk) != chunk.size()) { out.cancelWriting(); return; }
+        left -= chunk.size();
+    }
+    const qint64 shift = acked_;
+    acked_ = 0;
+    saveAck();                 // 先写 0：替换前退出只会导致重发，不会漏发
+    syncFile(ack_);
+    writer_.close();
+    reader_.close();           // Windows 下替换打开着的文件会失败
+    const bool ok = out.commit();
+    writer_.open(QIODevice::ReadWrite);
+    reader_.open(QIODevice::ReadOnly);
+    if (!ok) {
+        acked_ = shift;
+        saveAck();
+        writer_.seek(end_);
+        return;
+    }
+    end_ -= shift;
+    synced_ = end_;
+    sent_ = 0;
+    writer_.seek(end_);
+}
+
+void OutboundSpool::saveAck(){
+    char a[8];
+    qToLittleEndian<qint64>(acked_, a);
+    ack_.seek(0);
+    ack_.write(a, 8);
+    ack_.flush();
+}
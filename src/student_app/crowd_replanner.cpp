@@ -0,0 +1,215 @@
+#include <seatui/student/crowd_replanner.hpp>
+#include <seatui/student/route_smoother.hpp>
+#include <QElapsedTimer>
+#include <algorithm>
+
+namespace {
+// 方向表：前 4 个直行，后 4 个斜行（与 PathFinder 一致）
+const int DX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+const int DY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+// 枚举 (x,y) 的可行边：目标格可走，斜行还要求两侧直行格可走。网格无向，前驱与后继相同
+template <class F>
+inline void forEachEdge(const NavGrid& g, int x, int y, F&& fn){
+    for (int k = 0; k < 8; ++k) {
+        const int nx = x + DX[k], ny = y + DY[k];
+        if (!g.walkable(nx, ny)) continue;
+        if (k >= 4 && (!g.walkable(nx, y) || !g.walkable(x, ny))) continue;
+        fn(nx, ny, k < 4 ? PathFinder::kStraight : PathFinder::kDiagonal);
+    }
+}
+
+inline quint32 addSat(quint32 a, quint32 b){
+    return (a == LpaPlanner::kInf || b == LpaPlanner::kInf) ? LpaPlanner::kInf : a + b;
+}
+}
+
+/* ---------- LpaPlanner ---------- */
+void LpaPlanner::reset(const NavGrid& grid, const std::vector<quint16>& pen, const QPoint& start, const QPoint& goal){
+    start_ = start;
+    goal_  = goal;
+    cols_  = grid.cols();
+    g_.assign(size_t(grid.cellCount()), kInf);
+    rhs_.assign(size_t(grid.cellCount()), kInf);
+    heap_.clear();
+    startIdx_ = grid.inBounds(start.x(), start.y()) ? grid.index(start.x(), start.y()) : -1;
+    goalIdx_  = grid.inBounds(goal.x(), goal.y())   ? grid.index(goal.x(), goal.y())   : -1;
+    if (startIdx_ < 0 || goalIdx_ < 0 || !grid.walkable(goal)) return;
+
+    rhs_[size_t(goalIdx_)] = 0;
+    push(goalIdx_);
+    compute(grid, pen);
+}
+
+LpaPlanner::Key LpaPlanner::calcKey(int idx) const {
+    // 启发式：到起点的八方向距离（附加值非负，仍可采纳）
+    const quint32 m = qMin(g_[size_t(idx)], rhs_[size_t(idx)]);
+    const int x = idx % cols_, y = idx / cols_;
+    const quint32 h = PathFinder::octile(x - start_.x(), y - start_.y());
+    return Key{ addSat(m, h), m };
+}
+
+void LpaPlanner::push(int idx){
+    heap_.push_back(Entry{ calcKey(idx), idx });
+    std::push_heap(heap_.begin(), heap_.end(), [](const Entry& a, const Entry& b){ return b.key < a.key; });
+}
+
+void LpaPlanner::updateVertex(const NavGrid& grid, const std::vector<quint16>& pen, int idx){
+    if (idx != goalIdx_) {
+        const int x = idx % cols_, y = idx / cols_;
+        quint32 best = kInf;
+        if (grid.walkable(x, y)) {
+            forEachEdge(grid, x, y, [&](int nx, int ny, quint32 w){
+                const int n = ny * cols_ + nx;
+                best = qMin(best, addSat(g_[size_t(n)], w + pen[size_t(n)]));
+            });
+        }
+        rhs_[size_t(idx)] = best;
+    }
+    if (g_[size_t(idx)] != rhs_[size_t(idx)]) push(idx);   // 旧条目留在堆里，出队时按一致性丢弃
+}
+
+void LpaPlanner::cellChanged(const NavGrid& grid, const std::vector<quint16>& pen, const QPoint& c){
+    if (startIdx_ < 0 || goalIdx_ < 0) return;
+    for (int dy = -1; dy <= 1; ++dy)
+        for (int dx = -1; dx <= 1; ++dx)
+            if (grid.inBounds(c.x() + dx, c.y() + dy))
+                updateVertex(grid, pen, grid.index(c.x() + dx, c.y() + dy));
+}
+
+bool LpaPlanner::compute(const NavGrid& grid, const std::vector<quint16>& pen){
+    expanded_ = 0;
+    if (startIdx_ < 0 || goalIdx_ < 0) return false;
+    auto cmp = [](const Entry& a, const Entry& b){ return b.key < a.key; };
+    const size_t s = size_t(startIdx_);
+
+    while (!heap_.empty()) {
+        const Entry top = heap_.front();
+        if (!(top.key < calcKey(startIdx_)) && g_[s] == rhs_[s]) break;
+        std::pop_heap(heap_.begin(), heap_.end(), cmp);
+        heap_.pop_back();
+
+        const int u = top.idx;
+        const size_t su = size_t(u);
+        if (g_[su] == rhs_[su]) continue;                  // 已一致：过期条目
+        const Key now = calcKey(u);
+        if (top.key < now) { push(u); continue; }          // 键值变大：按新键重新排队
+
+        ++expanded_;
+        const int x = u % cols_, y = u / cols_;
+        if (g_[su] > rhs_[su]) {
+            g_[su] = rhs_[su];                              // 过一致：定下来，向邻居传播降值
+        } else {
+            g_[su] = kInf;                                  // 欠一致：作废后自身与邻居重算
+            updateVertex(grid, pen, u);
+        }
+        forEachEdge(grid, x, y, [&](int nx, int ny, quint32){
+            updateVertex(grid, pen, ny * cols_ + nx);
+        });
+    }
+    return g_[s] != kInf;
+}
+
+NavRoute LpaPlanner::route(const NavGrid& grid, const std::vector<quint16>& pen) const {
+    NavRoute r;
+    if (cost() == kInf) return r;
+
+    QPoint cur = start_;
+    r.cost = cost();
+    r.cells << cur;
+    for (int guard = int(g_.size()); cur != goal_ && guard > 0; --guard) {
+        quint32 best = kInf;
+        QPoint next;
+        forEachEdge(grid, cur.x(), cur.y(), [&](int nx, int ny, quint32 w){
+            const int n = ny * cols_ + nx;
+            const quint32 c = addSat(g_[size_t(n)], w + pen[size_t(n)]);
+            if (c < best) { best = c; next = QPoint(nx, ny); }
+        });
+        if (best == kInf) return NavRoute();
+        cur = next;
+        r.cells << cur;
+    }
+    return cur == goal_ ? r : NavRoute();
+}
+
+/* ---------- CrowdReplanner ---------- */
+void CrowdReplanner::reset(const NavGrid& grid){
+    grid_ = grid;
+    pen_.assign(size_t(grid.cellCount()), 0);
+    dirtyMark_.assign(size_t(grid.cellCount()), 0);
+    dirty_.clear();
+    congested_ = 0;
+    legs_.clear();
+}
+
+void CrowdReplanner::setLegs(const QVector<QPair<QPoint, QPoint>>& legs){
+    QElapsedTimer t; t.start();
+    legs_.resize(legs.size());
+    expanded_ = 0;
+    for (int i = 0; i < legs.size(); ++i) {
+        legs_[i].reset(grid_, pen_, legs.at(i).first, legs.at(i).second);
+        expanded_ += legs_[i].lastExpanded();
+    }
+    repairMs_ = t.nsecsElapsed() / 1e6;
+}
+
+void CrowdReplanner::addPenalty(const QPoint& cell, int delta){
+    if (delta == 0 || !grid_.inBounds(cell.x(), cell.y())) return;
+    const size_t i = size_t(grid_.index(cell.x(), cell.y()));
+    const int before = pen_[i];
+    const int after  = qBound(0, before + delta, 0xFFFF);
+    if (after == before) return;
+    pen_[i] = quint16(after);
+    congested_ += (after > 0) - (before > 0);
+    markDirty(int(i));
+}
+
+void CrowdReplanner::setCellBlocked(const QPoint& cell, bool blocked){
+    if (!grid_.inBounds(cell.x(), cell.y()) || grid_.walkable(cell) == !blocked) return;
+    grid_.setWalkable(cell.x(), cell.y(), !blocked);
+    markDirty(grid_.index(cell.x(), cell.y()));      // LpaPlanner::cellChanged 连同斜行切角一起重算
+}
+
+void CrowdReplanner::markDirty(int idx){
+    if (!dirtyMark_[size_t(idx)]) { dirtyMark_[size_t(idx)] = 1; dirty_.push_back(idx); }
+}
+
+QVector<int> CrowdReplanner::commit(){
+    QElapsedTimer t; t.start();
+    QVector<int> changed;
+    expanded_ = 0;
+    if (!dirty_.empty()) {
+        for (int i = 0; i < legs_.size(); ++i) {
+            LpaPlanner& leg = legs_[i];
+            const quint32 before = leg.cost();
+            for (int idx : dirty_) leg.cellChanged(grid_, pen_, grid_.cellOf(idx));
+            leg.compute(grid_, pen_);
+            expanded_ += leg.lastExpanded();
+            if (leg.cost() != before) changed << i;
+        }
+        for (int idx : dirty_) dirtyMark_[size_t(idx)] = 0;
+        dirty_.clear();
+    }
+    repairMs_ = t.nsecsElapsed() / 1e6;
+    return changed;
+}
+
+NavRoute CrowdReplanner::legRoute(int i) const {
+    NavRoute r = legs_.at(i).route(grid_, pen_);
+    r.corners = RouteSmoother::stringPull(grid_, r.cells);
+    return r;
+}
+
+NavRoute CrowdReplanner::route() const {
+    NavRoute out;
+    for (int i = 0; i < legs_.size(); ++i) {
+        if (legs_.at(i).start() == legs_.at(i).goal()) continue;
+        const NavRoute leg = legRoute(i);
+        if (!leg.isValid()) return NavRoute();
+        const int skip = out.isValid() ? 1 : 0;
+        out.cells.append(leg.cells.mid(skip));
+        out.corners.append(leg.corners.mid(skip));
+        out.cost += leg.cost;
+    }
+    return out;
+}
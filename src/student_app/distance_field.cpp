@@ -0,0 +1,185 @@
+#include <seatui/student/distance_field.hpp>
+#include <seatui/student/nav_grid.hpp>
+#include <algorithm>
+#include <functional>
+
+namespace {
+// 方向表：前 4 个直行，后 4 个斜行（与 PathFinder 一致）
+const int DX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+const int DY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+// 枚举 (x,y) 的可行边：目标格可走，斜行还要求两侧直行格可走
+template <class F>
+inline void forEachEdge(const NavGrid& g, int x, int y, F&& fn){
+    for (int k = 0; k < 8; ++k) {
+        const int nx = x + DX[k], ny = y + DY[k];
+        if (!g.walkable(nx, ny)) continue;
+        if (k >= 4 && (!g.walkable(nx, y) || !g.walkable(x, ny))) continue;
+        fn(nx, ny, k < 4 ? PathFinder::kStraight : PathFinder::kDiagonal, k);
+    }
+}
+
+inline quint64 heapKey(quint32 d, int idx) { return (quint64(d) << 32) | quint32(idx); }
+}
+
+void DistanceField::build(const NavGrid& grid, const QPoint& goal){
+    goal_ = goal;
+    cols_ = grid.cols();
+    rows_ = grid.rows();
+    dist_.assign(size_t(grid.cellCount()), kInf);
+    mark_.assign(size_t(grid.cellCount()), 0);
+    gen_ = 0;
+    heap_.clear();
+    if (!grid.walkable(goal)) return;
+
+    const int gi = grid.index(goal.x(), goal.y());
+    dist_[size_t(gi)] = 0;
+    heap_.push_back(heapKey(0, gi));
+    int touched = 0;
+    relaxFrom(grid, touched);
+}
+
+void DistanceField::relaxFrom(const NavGrid& grid, int& touched){
+    const std::greater<quint64> cmp;
+    while (!heap_.empty()) {
+        std::pop_heap(heap_.begin(), heap_.end(), cmp);
+        const quint64 top = heap_.back();
+        heap_.pop_back();
+        const quint32 d = quint32(top >> 32);
+        const int i = int(top & 0xFFFFFFFFu);
+        if (d != dist_[size_t(i)]) continue;    // 过期副本
+
+        forEachEdge(grid, i % cols_, i / cols_, [&](int nx, int ny, quint32 w, int){
+            const int ni = ny * cols_ + nx;
+            const quint32 nd = d + w;
+            if (nd < dist_[size_t(ni)]) {
+                dist_[size_t(ni)] = nd;
+                heap_.push_back(heapKey(nd, ni));
+                std::push_heap(heap_.begin(), heap_.end(), cmp);
+                ++touched;
+            }
+        });
+    }
+}
+
+NavRoute DistanceField::descend(const NavGrid& grid, const QPoint& from) const {
+    NavRoute route;
+    if (!grid.walkable(from) || distance(from) == kInf) return route;
+
+    QPoint cur = from;
+    route.cost = distance(from);
+    route.cells.append(cur);
+    int prevDir = -1;
+    for (int guard = int(dist_.size()); cur != goal_ && guard > 0; --guard) {
+        const quint32 here = distance(cur);
+        int bestDir = -1;
+        QPoint best;
+        forEachEdge(grid, cur.x(), cur.y(), [&](int nx, int ny, quint32 w, int k){
+            const quint32 dn = dist_[size_t(ny * cols_ + nx)];
+            if (dn == kInf || dn + w != here) return;      // 只走最短路上的边
+            if (bestDir < 0 || k == prevDir) { bestDir = k; best = QPoint(nx, ny); }
+        });
+        if (bestDir < 0) return NavRoute();                // 场与网格不一致
+        prevDir = bestDir;                                 // 同向优先，少拐弯
+        cur = best;
+        route.cells.append(cur);
+    }
+    return cur == goal_ ? route : NavRoute();
+}
+
+int DistanceField::cellBlocked(const NavGrid& grid, const QPoint& c){
+    if (isEmpty() || !grid.inBounds(c.x(), c.y())) return 0;
+    if (c == goal_) { build(grid, goal_); return int(dist_.size()); }
+
+    const int ci = c.y() * cols_ + c.x();
+    if (dist_[size_t(ci)] == kInf) return 0;   // 原本就不可达/已阻断：无人依赖它
+
+    if (++gen_ == 0) { std::fill(mark_.begin(), mark_.end(), 0); gen_ = 1; }
+
+    // —— 1) 上抬：找出最短路依赖被删边的格子 —— //
+    // 被删的边都与 c 相邻（c 的入边 + 绕 c 的斜边），所以以 c 的 8 邻为候选即可
+    std::vector<int> invalid;
+    invalid.push_back(ci);
+    mark_[size_t(ci)] = gen_;
+    work_.clear();
+    for (int k = 0; k < 8; ++k) {
+        const int nx = c.x() + DX[k], ny = c.y() + DY[k];
+        if (grid.walkable(nx, ny)) work_.push_back(ny * cols_ + nx);
+    }
+    const int goalIdx = goal_.y() * cols_ + goal_.x();
+    while (!work_.empty()) {
+        const int v = work_.back();
+        work_.pop_back();
+        if (mark_[size_t(v)] == gen_ || v == goalIdx) continue;
+        const quint32 dv = dist_[size_t(v)];
+        if (dv == kInf) continue;
+
+        // 仍有一个有效邻居能给出同样的距离 → 不受影响
+        bool supported = false;
+        forEachEdge(grid, v % cols_, v / cols_, [&](int ux, int uy, quint32 w, int){
+            const int u = uy * cols_ + ux;
+            if (!supported && mark_[size_t(u)] != gen_ && dist_[size_t(u)] != kInf
+                && dist_[size_t(u)] + w == dv)
+                supported = true;
+        });
+        if (supported) continue;
+
+        mark_[size_t(v)] = gen_;
+        invalid.push_back(v);
+        // 依赖 v 的邻居需要重新检查
+        forEachEdge(grid, v % cols_, v / cols_, [&](int nx, int ny, quint32 w, int){
+            const int n = ny * cols_ + nx;
+            if (mark_[size_t(n)] != gen_ && dist_[size_t(n)] == dv + w) work_.push_back(n);
+        });
+    }
+
+    // —— 2) 修复：失效区从边界上的有效格重新做 Dijkstra —— //
+    for (int v : invalid) dist_[size_t(v)] = kInf;
+    heap_.clear();
+    const std::greater<quint64> cmp;
+    for (int v : invalid) {
+        const int vx = v % cols_, vy = v / cols_;
+        if (!grid.walkable(vx, vy)) continue;
+        quint32 best = kInf;
+        forEachEdge(grid, vx, vy, [&](int ux, int uy, quint32 w, int){
+            const quint32 du = dist_[size_t(uy * cols_ + ux)];
+            if (du != kInf) best = qMin(best, du + w);
+        });
+        if (best != kInf) {
+            dist_[size_t(v)] = best;
+            heap_.push_back(heapKey(best, v));
+            std::push_heap(heap_.begin(), heap_.end(), cmp);
+        }
+    }
+    int touched = 0;
+    relaxFrom(grid, touched);
+    return int(invalid.size());
+}
+
+int DistanceField::cellOpened(const NavGrid& grid, const QPoint& c){
+    if (isEmpty() || !grid.walkable(c)) return 0;
+    if (c == goal_) { build(grid, goal_); return int(dist_.size()); }
+
+    // 新增的边都与 c 相邻：以 c 及其 8 邻为种子做降值传播即可
+    const std::greater<quint64> cmp;
+    heap_.clear();
+    const int ci = c.y() * cols_ + c.x();
+    int touched = 0;
+    quint32 best = kInf;
+    forEachEdge(grid, c.x(), c.y(), [&](int nx, int ny, quint32 w, int){
+        const int n = ny * cols_ + nx;
+        const quint32 dn = dist_[size_t(n)];
+        if (dn == kInf) return;
+        best = qMin(best, dn + w);
+        heap_.push_back(heapKey(dn, n));
+        std::push_heap(heap_.begin(), heap_.end(), cmp);
+    });
+    if (best < dist_[size_t(ci)]) {
+        dist_[size_t(ci)] = best;
+        heap_.push_back(heapKey(best, ci));
+        std::push_heap(heap_.begin(), heap_.end(), cmp);
+        ++touched;
+    }
+    relaxFrom(grid, touched);
+    return touched;
+}
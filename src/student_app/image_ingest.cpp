@@ -0,0 +1,102 @@
+#include <seatui/student/image_ingest.hpp>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSet>
+#include <QThread>
+
+ImageIngest::ImageIngest(QObject* parent) : QObject(parent) {
+    pool_.setMaxThreadCount(qBound(2, QThread::idealThreadCount() / 2, 4));
+}
+
+ImageIngest::~ImageIngest(){
+    cancel();
+    pool_.waitForDone();
+}
+
+void ImageIngest::cancel(){
+    ++*gen_;
+    pool_.clear();
+    busy_ = false;
+}
+
+bool ImageIngest::preferPng(const QImage& img, const QByteArray& srcFormat){
+    // 照片源一律 JPEG：转成 PNG 只会更大
+    if (srcFormat == "jpeg" || srcFormat == "jpg") return false;
+
+    // 抽样最多 64×64 个像素：有半透明像素，或不同颜色不超过 256 种（截图、图标、示意图）→ PNG
+    const int sx = qMax(1, img.width() / 64), sy = qMax(1, img.height() / 64);
+    QSet<QRgb> colors;
+    bool alpha = false;
+    for (int y = 0; y < img.height(); y += sy) {
+        for (int x = 0; x < img.width(); x += sx) {
+            const QRgb c = img.pixel(x, y);
+            alpha |= qAlpha(c) < 255;
+            if (colors.size() <= 256) colors.insert(c);
+        }
+    }
+    return alpha || colors.size() <= 256;
+}
+
+quint64 ImageIngest::submit(const QString& file){
+    const quint64 gen = ++*gen_;
+    pool_.clear();              // 还没开始的旧任务直接丢掉
+    busy_ = true;
+    auto shared = gen_;
+
+    pool_.start([this, shared, gen, file]{
+        QElapsedTimer t; t.start();
+        auto stale = [&]{ return shared->load() != gen; };
+
+        // 1) 按上限解码：先读头部拿尺寸，再让解码器直接输出缩小后的图
+        QImageReader reader(file);
+        reader.setAutoTransform(true);
+        const QByteArray srcFormat = reader.format();
+        const QSize full = reader.size();
+        if (full.isValid() && qMax(full.width(), full.height()) > kMaxSide)
+            reader.setScaledSize(full.scaled(kMaxSide, kMaxSide, Qt::KeepAspectRatio));
+        QImage img = reader.read();
+        if (stale()) return;
+        if (img.isNull()) {
+            const QString why = reader.errorString();
+            QMetaObject::invokeMethod(this, [this, gen, why]{
+                if (gen != gen_->load()) return;
+                busy_ = false;
+                emit failed(gen, why);
+            }, Qt::QueuedConnection);
+            return;
+        }
+
+        // 2) 预览交给另一个工作线程，与编码并行（QImage 隐式共享，只读跨线程安全）
+        pool_.start([this, shared, gen, img]{
+            const QImage preview = img.scaled(kPreviewW, kPreviewH, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            if (shared->load() != gen) return;
+            QMetaObject::invokeMethod(this, [this, gen, preview]{
+                if (gen == gen_->load()) emit previewReady(gen, preview);
+            }, Qt::QueuedConnection);
+        });
+
+        // 3) 按内容选格式编码
+        const bool png = preferPng(img, srcFormat);
+        QByteArray bytes;
+        {
+            QBuffer buf(&bytes);
+            buf.open(QIODevice::WriteOnly);
+            if (png) img.save(&buf, "PNG");     // zlib 默认级别：比原先的高压缩级别快得多，体积相差不大
+            else     img.convertToFormat(QImage::Format_RGB32).save(&buf, "JPEG", kJpegQuality);
+        }
+        if (stale()) return;
+
+        const QString mime = png ? QStringLiteral("image/png") : QStringLiteral("image/jpeg");
+        const QString name = QFileInfo(file).completeBaseName() + (png ? ".png" : ".jpg");
+        const QSize   size = img.size();
+        const double  ms   = t.nsecsElapsed() / 1e6;
+        QMetaObject::invokeMethod(this, [this, gen, bytes, mime, name, size, ms]{
+            if (gen != gen_->load()) return;
+            busy_ = false;
+            emit encoded(gen, bytes, mime, name, size, ms);
+        }, Qt::QueuedConnection);
+    });
+    return gen;
+}
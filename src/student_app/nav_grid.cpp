@@ -0,0 +1,77 @@
+#include <seatui/student/nav_grid.hpp>
+#include <QtMath>
+
+NavGrid::NavGrid(const QPoint& origin, int cell, int cols, int rows)
+    : origin_(origin), cell_(qMax(1, cell)), cols_(qMax(0, cols)), rows_(qMax(0, rows))
+{
+    stride_ = (cols_ + 63) / 64;
+    bits_.assign(size_t(stride_) * size_t(rows_), 0);
+}
+
+void NavGrid::setWalkable(int x, int y, bool on){
+    if (!inBounds(x, y)) return;
+    quint64& w = bits_[size_t(y) * stride_ + (unsigned(x) >> 6)];
+    const quint64 m = quint64(1) << (x & 63);
+    if (on) w |= m; else w &= ~m;
+}
+
+void NavGrid::fill(bool walkable){
+    std::fill(bits_.begin(), bits_.end(), walkable ? ~quint64(0) : quint64(0));
+    // 行尾多出来的位保持为 0，避免位运算扫描时误判
+    const int tail = cols_ & 63;
+    if (walkable && tail) {
+        const quint64 mask = (quint64(1) << tail) - 1;
+        for (int y = 0; y < rows_; ++y)
+            bits_[size_t(y) * stride_ + stride_ - 1] &= mask;
+    }
+}
+
+void NavGrid::blockRect(const QRectF& px){
+    if (isEmpty() || px.isEmpty()) return;
+    // 格心 = origin + i*cell + cell/2，落在 [left, right) 内的格子被占用
+    const qreal half = cell_ * 0.5;
+    const int x0 = qMax(0,         qCeil((px.left()   - origin_.x() - half) / cell_));
+    const int x1 = qMin(cols_ - 1, qCeil((px.right()  - origin_.x() - half) / cell_) - 1);
+    const int y0 = qMax(0,         qCeil((px.top()    - origin_.y() - half) / cell_));
+    const int y1 = qMin(rows_ - 1, qCeil((px.bottom() - origin_.y() - half) / cell_) - 1);
+    for (int y = y0; y <= y1; ++y)
+        for (int x = x0; x <= x1; ++x)
+            setWalkable(x, y, false);
+}
+
+QPoint NavGrid::cellAt(const QPointF& px) const {
+    return QPoint(qFloor((px.x() - origin_.x()) / cell_),
+                  qFloor((px.y() - origin_.y()) / cell_));
+}
+
+QPointF NavGrid::cellCenter(const QPoint& c) const {
+    return QPointF(origin_.x() + (c.x() + 0.5) * cell_,
+                   origin_.y() + (c.y() + 0.5) * cell_);
+}
+
+QPoint NavGrid::nearestWalkable(const QPoint& c) const {
+    if (isEmpty()) return QPoint(-1, -1);
+    const QPoint s(qBound(0, c.x(), cols_ - 1), qBound(0, c.y(), rows_ - 1));
+    if (walkable(s)) return s;
+
+    std::vector<quint8> seen(size_t(cellCount()), 0);
+    std::vector<int> queue;
+    queue.reserve(64);
+    queue.push_back(index(s.x(), s.y()));
+    seen[size_t(queue.back())] = 1;
+    static const int DX[4] = { 1, -1, 0, 0 };
+    static const int DY[4] = { 0, 0, 1, -1 };
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const QPoint p = cellOf(queue[head]);
+        for (int k = 0; k < 4; ++k) {
+            const int nx = p.x() + DX[k], ny = p.y() + DY[k];
+            if (!inBounds(nx, ny)) continue;
+            const int ni = index(nx, ny);
+            if (seen[size_t(ni)]) continue;
+            if (walkable(nx, ny)) return QPoint(nx, ny);
+            seen[size_t(ni)] = 1;
+            queue.push_back(ni);
+        }
+    }
+    return QPoint(-1, -1);
+}
@@ -0,0 +1,148 @@
+#include <seatui/student/nav_router.hpp>
+#include <seatui/student/route_smoother.hpp>
+#include <QElapsedTimer>
+
+void NavRouter::reset(const NavGrid& grid, const QPoint& startCell, const QVector<QPoint>& goalCells){
+    QElapsedTimer t; t.start();
+    grid_  = grid;
+    start_ = startCell;
+    goals_ = goalCells;
+    cache_.clear();
+    poiFields_.clear();
+    matrixPois_.clear();
+    matrix_.clear();
+
+    fields_.resize(goals_.size());
+    for (int i = 0; i < goals_.size(); ++i)
+        fields_[i].build(grid_, goals_.at(i));
+    buildMs_ = t.nsecsElapsed() / 1e6;
+}
+
+NavRoute NavRouter::routeTo(int goal){
+    QElapsedTimer t; t.start();
+    lastCached_ = false;
+
+    NavRoute route;
+    if (goal < 0 || goal >= goals_.size()) {
+        lastMs_ = 0.0;
+        return route;
+    }
+
+    auto it = cache_.constFind(goal);
+    if (it != cache_.constEnd()) {
+        lastCached_ = true;
+        route = it.value();
+    } else {
+        route = routeFrom(start_, goal);
+        cache_.insert(goal, route);     // 不可达也缓存，避免反复搜索
+    }
+    lastMs_ = t.nsecsElapsed() / 1e6;
+    return route;
+}
+
+NavRoute NavRouter::routeFrom(const QPoint& fromCell, int goal) const {
+    const DistanceField* f = field(goal);
+    return f ? withCorners(f->descend(grid_, fromCell)) : NavRoute();
+}
+
+NavRoute NavRouter::route(const QPoint& fromCell, const QPoint& toCell){
+    return withCorners(finder_.find(grid_, fromCell, toCell));
+}
+
+NavRoute NavRouter::withCorners(NavRoute route) const {
+    route.corners = RouteSmoother::stringPull(grid_, route.cells);
+    return route;
+}
+
+int NavRouter::setCellBlocked(const QPoint& cell, bool blocked){
+    if (!grid_.inBounds(cell.x(), cell.y()) || grid_.walkable(cell) == !blocked) return 0;
+
+    QElapsedTimer t; t.start();
+    grid_.setWalkable(cell.x(), cell.y(), !blocked);
+    int touched = 0;
+    for (DistanceField& f : fields_)
+        touched += blocked ? f.cellBlocked(grid_, cell) : f.cellOpened(grid_, cell);
+    for (PoiField& p : poiFields_)
+        touched += blocked ? p.field.cellBlocked(grid_, cell) : p.field.cellOpened(grid_, cell);
+    cache_.clear();
+    matrixPois_.clear();
+    buildMs_ = t.nsecsElapsed() / 1e6;
+    return touched;
+}
+
+const DistanceField& NavRouter::fieldAt(const QPoint& cell){
+    const int g = goals_.indexOf(cell);
+    if (g >= 0) return fields_.at(g);
+
+    const int key = grid_.inBounds(cell.x(), cell.y()) ? grid_.index(cell.x(), cell.y()) : -1;
+    auto it = poiFields_.find(key);
+    if (it == poiFields_.end()) {
+        if (poiFields_.size() >= kMaxPoiFields) {
+            // 只淘汰没钉住的；全钉住时（兴趣点超过上限）宁可暂时多留一张
+            auto victim = poiFields_.end();
+            for (auto v = poiFields_.begin(); v != poiFields_.end(); ++v)
+                if (!v->pinned && (victim == poiFields_.end() || v->used < victim->used)) victim = v;
+            if (victim != poiFields_.end()) poiFields_.erase(victim);
+        }
+        it = poiFields_.insert(key, PoiField());
+        it->field.build(grid_, cell);
+    }
+    it->used = ++poiTick_;
+    return it->field;
+}
+
+void NavRouter::unpinPoiFields(){
+    for (PoiField& p : poiFields_) p.pinned = false;
+    // 钉住期间超出上限多留的场，解钉后按 LRU 收回
+    while (poiFields_.size() > kMaxPoiFields) {
+        auto victim = poiFields_.begin();
+        for (auto v = poiFields_.begin(); v != poiFields_.end(); ++v)
+            if (v->used < victim->used) victim = v;
+        poiFields_.erase(victim);
+    }
+}
+
+const QVector<quint32>& NavRouter::distanceMatrix(const QVector<QPoint>& pois){
+    // 本组兴趣点的场钉住，接下来的 routeThrough 直接复用
+    unpinPoiFields();
+    if (pois == matrixPois_ && !matrix_.isEmpty()) {
+        for (const QPoint& c : pois) {
+            auto it = grid_.inBounds(c.x(), c.y()) ? poiFields_.find(grid_.index(c.x(), c.y())) : poiFields_.end();
+            if (it != poiFields_.end()) it->pinned = true;
+        }
+        return matrix_;
+    }
+
+    QElapsedTimer t; t.start();
+    const int n = pois.size();
+    matrix_.fill(DistanceField::kInf, n * n);
+    for (int j = 0; j < n; ++j) {
+        // 一张距离场给出一整列：i → j 的代价即 j 的场在 i 处的值
+        const DistanceField& f = fieldAt(pois.at(j));
+        for (int i = 0; i < n; ++i)
+            matrix_[i * n + j] = (i == j) ? 0 : f.distance(pois.at(i));
+        const QPoint& c = pois.at(j);
+        if (grid_.inBounds(c.x(), c.y()) && goals_.indexOf(c) < 0)
+            poiFields_[grid_.index(c.x(), c.y())].pinned = true;
+    }
+    matrixPois_ = pois;
+    buildMs_ = t.nsecsElapsed() / 1e6;
+    return matrix_;
+}
+
+NavRoute NavRouter::routeThrough(const QVector<QPoint>& stops){
+    NavRoute out;
+    for (int i = 0; i + 1 < stops.size(); ++i) {
+        if (stops.at(i) == stops.at(i + 1)) continue;
+        const NavRoute leg = withCorners(fieldAt(stops.at(i + 1)).descend(grid_, stops.at(i)));
+        if (!leg.isValid()) { unpinPoiFields(); return NavRoute(); }
+
+        // 段与段首尾相接：后一段去掉重复的起点
+        const int skip = out.isValid() ? 1 : 0;
+        out.cells.append(leg.cells.mid(skip));
+        out.corners.append(leg.corners.mid(skip));
+        out.cost += leg.cost;
+    }
+    unpinPoiFields();           // 本次求解结束，之后按 LRU 正常淘汰
+    return out;
+}
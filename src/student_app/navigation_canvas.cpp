@@ -1,53 +1,506 @@
 #include <seatui/student/navigation_canvas.hpp>
+#include <seatui/student/route_smoother.hpp>
 #include <QPainter>
 #include <QLinearGradient>
 #include <QFont>
 #include <QImage>
+#include <QPolygonF>
+#include <QPainterPath>
+#include <QRegion>
 #include <QtMath>
+#include <utility>
 
 NavigationCanvas::NavigationCanvas(QWidget* parent) : QWidget(parent) {
     setMinimumSize(680, 440);
     setAutoFillBackground(false);
+    setMouseTracking(true);     // 悬停高亮需要无按键时的移动事件
+
+    m_refineTimer.setSingleShot(true);
+    m_refineTimer.setInterval(kRefineDelayMs);
+    connect(&m_refineTimer, &QTimer::timeout, this, &NavigationCanvas::onRefineTimeout);
+    connect(&m_tiles, &SceneTileCache::tileReady, this, [this](const QRect& r){ update(r); });
+
+    m_animTimer.setTimerType(Qt::PreciseTimer);
+    m_animTimer.setInterval(16);
+    connect(&m_animTimer, &QTimer::timeout, this, &NavigationCanvas::onAnimTick);
+
+    m_replanTimer.setSingleShot(true);
+    m_replanTimer.setInterval(30);
+    connect(&m_replanTimer, &QTimer::timeout, this, &NavigationCanvas::onReplan);
 }
 
 void NavigationCanvas::setSuperSample(bool on){
-    if (useSSAA != on) { useSSAA = on; update(); }
+    if (useSSAA != on) { useSSAA = on; update(); }   // 瓦片按新倍数在后台逐块精修
 }
 
 void NavigationCanvas::resizeEvent(QResizeEvent*){
+    beginInteraction();         // 拖动窗口期间每帧都要重建静态层，先用低成本画质
     updateLayout(width(), height());
-    msaaBuffer = QImage(width()*2, height()*2, QImage::Format_RGBA8888);
-    msaaBuffer.fill(Qt::transparent);
+    clampView();
+    applyView();
+    invalidateStatic();
+}
+
+void NavigationCanvas::beginInteraction(){
+    m_interactive = true;
+    m_refineTimer.start();      // 重复调用只会推迟精修，不会叠加定时器
+}
+
+void NavigationCanvas::onRefineTimeout(){
+    m_interactive = false;
+    if (useSSAA) update();      // 低倍数瓦片与图集在绘制时按新倍数重建
+}
+
+qreal NavigationCanvas::superSampleFactor() const {
+    if (!useSSAA || m_interactive) return 1.0;
+    // 以设备像素为基准：普通屏 2×；DPR ≥ 2 的高分屏设备像素已足够细，不再超采样
+    return qMax(1.0, qreal(qCeil(2.0 / devicePixelRatioF())));
+}
+
+/* ---------- 视口 ---------- */
+void NavigationCanvas::setView(qreal zoom, const QPointF& pan){
+    m_zoom = qBound(kMinZoom, zoom, kMaxZoom);
+    m_pan  = pan;
+    clampView();
+    applyView();
+}
+
+void NavigationCanvas::resetView(){
+    setView(1.0, QPointF());
+}
+
+void NavigationCanvas::zoomAt(const QPointF& screenPos, qreal factor){
+    // 保持光标下的世界点不动：pan' = s - (s - pan) * z'/z
+    const qreal z = qBound(kMinZoom, m_zoom * factor, kMaxZoom);
+    if (qFuzzyCompare(z, m_zoom)) return;
+    setView(z, screenPos - (screenPos - m_pan) * (z / m_zoom));
+}
+
+void NavigationCanvas::clampView(){
+    // 内容小于窗口时可在窗口内移动，大于窗口时不留出空白
+    const QSizeF content = QSizeF(lay.W, lay.H) * m_zoom;
+    const qreal dx = width() - content.width(), dy = height() - content.height();
+    m_pan.setX(qBound(qMin(0.0, dx), m_pan.x(), qMax(0.0, dx)));
+    m_pan.setY(qBound(qMin(0.0, dy), m_pan.y(), qMax(0.0, dy)));
+}
+
+void NavigationCanvas::applyView(){
+    // 平移对齐到设备像素：瓦片按整像素贴出，不产生重采样模糊
+    const qreal dpr = devicePixelRatioF();
+    m_pan     = QPointF(qRound(m_pan.x() * dpr) / dpr, qRound(m_pan.y() * dpr) / dpr);
+    m_view    = QTransform(m_zoom, 0, 0, m_zoom, m_pan.x(), m_pan.y());
+    m_viewInv = m_view.inverted();
+    beginInteraction();         // 连续滚轮/拖动期间新瓦片走低成本画质
+    update();                   // 瓦片按缩放级别缓存；座位图集按缩放后的尺寸在绘制时重建
+}
+
+void NavigationCanvas::invalidateStatic(){
+    m_staticDirty = true;
+    update();
 }
 
 void NavigationCanvas::updateLayout(int W, int H){
-    lay.W = W; lay.H = H;
-    lay.margin = int(0.06 * qMin(W, H));
-    lay.rectInner = QRect(lay.margin, lay.margin, W - 2*lay.margin, H - 2*lay.margin);
+    const QVector<int> oldIds = lay.seatId;
+    lay = SeatLayout::build(m_params, W, H);
+    m_index.build(lay);
+
+    // 序号随布局变化，座位按稳定编号对应过去：实时状态从 m_seatById 重铺，
+    // 选中随座位搬到新序号，新布局里排不下的座位取消选中
+    m_hoverSeat = -1;
+    m_seatState.fill(quint8(SeatState::Free), lay.seatCount());
+    for (auto it = m_seatById.constBegin(); it != m_seatById.constEnd(); ++it) {
+        const int seat = lay.indexOf(it.key());
+        if (seat >= 0) m_seatState[seat] = it.value();
+    }
+    const int hadSelected = m_selectedIds.size();
+    QVector<int> selected;
+    for (int seat : std::as_const(m_selectedIds)) {
+        const int moved = lay.indexOf(oldIds.value(seat, -1));
+        if (moved >= 0) selected << moved;
+    }
+    m_selected.fill(0, lay.seatCount());
+    for (int seat : std::as_const(selected)) m_selected[seat] = 1;
+    m_selectedIds = selected;
+    if (m_selectedIds.size() != hadSelected) emit selectionChanged(m_selectedIds.size());
+    m_fragmentsDirty = true;
+
+    rebuildNavGrid();           // 多点路线会用到选座，放在选中集合校正之后
+}
+
+void NavigationCanvas::rebuildNavGrid(){
+    const int cell = lay.prm.cell;
+    NavGrid grid(lay.gridRect.topLeft(), cell, lay.gridCols, lay.gridRows);
+    grid.fill(true);
+
+    // 书架背板与座位（按可见矩形，即扣掉 seatGap 后）都不可走
+    for (const QRect& r : lay.shelfRects)
+        grid.blockRect(QRectF(r));
+    for (int i = 0; i < lay.seatCount(); ++i)
+        grid.blockRect(lay.seatRect(i));
+
+    // 目的地：书架徽标正下方第一格；起点：START 所在格
+    QVector<QPoint> goals;
+    goals.reserve(lay.shelfRects.size());
+    for (const QRect& r : lay.shelfRects)
+        goals.push_back(grid.nearestWalkable(
+            grid.cellAt(QPointF(r.center().x(), r.bottom() + 1 + cell * 0.5))));
+    const QPoint start = grid.nearestWalkable(grid.cellAt(QPointF(lay.startPt) + QPointF(0.5, 0.5)));
+
+    m_router.reset(grid, start, goals);
+
+    // 拥挤附加值按当前座位状态重新铺到新网格上
+    m_crowd.reset(grid);
+    for (int i = 0; i < m_seatState.size() && i < lay.seatCount(); ++i)
+        applySeatCrowd(i, crowdWeight(SeatState(m_seatState.at(i))));
+    m_crowd.commit();
+
+    // 布局变了：当前路径按新网格重算
+    if (m_tourActive) planTour();
+    else if (m_routeShelf >= 0) showRoute(m_routeShelf);
+    else setRoute(NavRoute());
+}
+
+bool NavigationCanvas::showRoute(int shelf){
+    m_tourActive = false;
+    m_routeShelf = shelf;
+    setActiveRoute(m_router.routeTo(shelf), { qMakePair(m_router.startCell(), m_router.goalCell(shelf)) });
+    update();
+    return m_route.isValid();
+}
+
+void NavigationCanvas::clearRoute(){
+    m_tourActive = false;
+    m_routeShelf = -1;
+    m_crowd.setLegs({});
+    setRoute(NavRoute());
+    update();
+}
+
+void NavigationCanvas::setActiveRoute(const NavRoute& plain, const QVector<QPair<QPoint, QPoint>>& legs){
+    // 在途路线交给增量规划器跟踪；没有拥挤时直接用缓存的距离场路径
+    m_crowd.setLegs(legs);
+    setRoute(m_crowd.hasCongestion() ? m_crowd.route() : plain);
+}
+
+/* ---------- 拥挤感知重规划 ---------- */
+void NavigationCanvas::applySeatCrowd(int seat, int delta){
+    if (delta == 0 || seat < 0 || seat >= lay.seatCount()) return;
+    // 座位外扩一格范围内的过道格
+    const NavGrid& grid = m_router.grid();
+    const qreal cell = lay.prm.cell;
+    const QRectF ring = lay.seatRect(seat).adjusted(-cell, -cell, cell, cell);
+    const QPoint c0 = grid.cellAt(ring.topLeft()), c1 = grid.cellAt(ring.bottomRight());
+    for (int y = c0.y(); y <= c1.y(); ++y)
+        for (int x = c0.x(); x <= c1.x(); ++x)
+            if (grid.walkable(x, y) && ring.contains(grid.cellCenter(QPoint(x, y))))
+                m_crowd.addPenalty(QPoint(x, y), delta);
+}
 
-    // 顶部四个书架 A/B/C/D
-    const int n = 4;
-    const int colW = lay.rectInner.width() / n;
-    lay.shelfCenters.clear();
-    for (int k = 0; k < n; ++k) {
-        const int x = lay.rectInner.left() + colW * k + colW / 2;
-        const int y = lay.rectInner.top() + int(0.12 * lay.rectInner.height());
-        lay.shelfCenters.push_back(QPoint(x, y));
+int NavigationCanvas::setCellBlocked(const QPoint& cell, bool blocked){
+    const int touched = m_router.setCellBlocked(cell, blocked);
+    m_crowd.setCellBlocked(cell, blocked);      // 规划器持有网格副本，阻断要同步过去
+    if (blocked && m_route.cells.contains(cell)) m_rerouteForced = true;
+    m_replanTimer.start();
+    return touched;
+}
+
+void NavigationCanvas::onReplan(){
+    const QVector<int> changed = m_crowd.commit();
+    const bool forced = std::exchange(m_rerouteForced, false);
+    if ((changed.isEmpty() && !forced) || m_crowd.legCount() == 0) return;   // 代价没变的路线不重发
+
+    const QRect before = m_view.mapRect(m_routeBounds).toAlignedRect();
+    setRoute(m_crowd.route());
+    update((before | m_view.mapRect(m_routeBounds).toAlignedRect()).adjusted(-2, -2, 2, 2));
+    emit routeReplanned(m_route.cost, m_crowd.lastRepairMs(), changed.size());
+}
+
+void NavigationCanvas::setRoute(const NavRoute& route){
+    m_route = route;
+    m_routeLine.clear();
+    m_routePath = QPainterPath();
+    m_routeBounds = QRectF();
+    m_glow.clear();
+    updateAnimation();
+    if (!m_route.isValid()) return;
+
+    const NavGrid& grid = m_router.grid();
+    m_routeLine.reserve(m_route.corners.size() + 2);
+    m_routeLine << QPointF(lay.startPt);
+    for (const QPoint& c : m_route.corners)
+        m_routeLine << grid.cellCenter(c);
+    if (m_routeShelf >= 0 && m_routeShelf < lay.shelfRects.size()) {
+        const QRect& shelf = lay.shelfRects.at(m_routeShelf);
+        m_routeLine << QPointF(shelf.center().x(), shelf.bottom());   // 终点落到书架徽标
+    }
+
+    // 平滑只在路径变化时做一次，重绘直接画缓存的贝塞尔路径
+    m_routePath = RouteSmoother::fitBezier(m_routeLine, kRouteCornerCells * lay.prm.cell);
+    m_glow.setPath(m_routePath);
+    m_routeBounds = m_routePath.boundingRect().adjusted(-3, -3, 3, 3) | m_glow.bounds();   // 含线宽与光晕
+    updateAnimation();
+}
+
+/* ---------- 多点路线 ---------- */
+bool NavigationCanvas::showTour(const QVector<int>& shelves){
+    m_tourShelves.clear();
+    for (int s : shelves)
+        if (s >= 0 && s < m_router.goalCount() && !m_tourShelves.contains(s)) m_tourShelves << s;
+    m_tourActive = true;
+    const bool ok = planTour();
+    update();
+    return ok;
+}
+
+bool NavigationCanvas::planTour(){
+    static const char* const labels[] = { "A", "B", "C", "D" };
+    const NavGrid& grid = m_router.grid();
+
+    // 兴趣点：0 号为 START，其后为书架与选中座位旁最近的过道格
+    QVector<QPoint> pois { m_router.startCell() };
+    QVector<int>    shelfOf { -1 };
+    QStringList     names { QStringLiteral("START") };
+    for (int s : std::as_const(m_tourShelves)) {
+        pois << m_router.goalCell(s);
+        shelfOf << s;
+        names << (s < 4 ? QString::fromLatin1(labels[s]) : QString::number(s));
+    }
+    // 每个非书架兴趣点要一张整网格距离场：座位站数封顶，让 START 与全部座位的场都留在
+    // 路由器的缓存里（求解期间不淘汰、不重建），超出的按选中先后舍去并告知调用方
+    const int maxSeats = qMax(0, NavRouter::kMaxPoiFields - 1 - int(m_tourShelves.size()));
+    const int seats    = qMin(int(m_selectedIds.size()), maxSeats);
+    m_tourSeatsDropped = int(m_selectedIds.size()) - seats;
+    for (int k = 0; k < seats; ++k) {
+        const int id = m_selectedIds.at(k);
+        pois << grid.nearestWalkable(grid.cellAt(lay.seatRect(id).center()));
+        shelfOf << -1;
+        names << QString(u8"座位%1").arg(lay.seatId.at(id));
+    }
+
+    m_tour = TourPlanner::solve(m_router.distanceMatrix(pois), pois.size());
+    m_tourStops.clear();
+    if (!m_tour.isValid()) {
+        m_routeShelf = -1;
+        m_crowd.setLegs({});
+        setRoute(NavRoute());
+        return false;
+    }
+
+    QVector<QPoint> stops { pois.first() };
+    for (int v : std::as_const(m_tour.order)) {
+        stops << pois.at(v);
+        m_tourStops << names.at(v);
+    }
+    m_routeShelf = shelfOf.at(m_tour.order.last());
+    QVector<QPair<QPoint, QPoint>> legs;
+    for (int i = 0; i + 1 < stops.size(); ++i) legs << qMakePair(stops.at(i), stops.at(i + 1));
+    setActiveRoute(m_router.routeThrough(stops), legs);
+    return m_route.isValid();
+}
+
+/* ---------- 路径动画 ---------- */
+void NavigationCanvas::updateAnimation(){
+    const bool run = m_glow.isActive() && isVisible();
+    if (run == m_animTimer.isActive()) return;
+    if (run) { m_animClock.start(); m_statFrames = 0; m_animTimer.start(); }
+    else     m_animTimer.stop();
+}
+
+void NavigationCanvas::onAnimTick(){
+    // 用真实间隔推进，掉帧时粒子速度不变；切回窗口等长间隔封顶
+    const qreal dt = qMin<qreal>(m_animClock.restart() / 1000.0, 0.05);
+    m_glow.advance(dt);
+    update(m_view.mapRect(m_routeBounds).toAlignedRect().adjusted(-2, -2, 2, 2));
+
+    if (++m_statFrames >= 60) {
+        m_statFrames = 0;
+        emit routeFrameStats(m_glow.frameMs(), m_glow.peakMs(), m_glow.particleCount());
     }
+}
+
+void NavigationCanvas::showEvent(QShowEvent* e){
+    QWidget::showEvent(e);
+    updateAnimation();
+}
 
-    // START：右下角、对齐网格、离边各 2 格
-    const int cell = m_cell;
-    const int rx = snapDn(lay.rectInner.right(), cell)  - m_borderCells * cell - 2*cell;
-    const int ry = snapDn(lay.rectInner.bottom(), cell) - m_borderCells * cell - 2*cell;
-    lay.startPt = QPoint(rx, ry);
+void NavigationCanvas::hideEvent(QHideEvent* e){
+    QWidget::hideEvent(e);
+    updateAnimation();
+}
+
+/* ---------- 选座：悬停 / 点选 / 框选 ---------- */
+QRect NavigationCanvas::seatDamageRect(int seat) const {
+    if (seat < 0 || seat >= lay.seatCount()) return QRect();
+    return m_view.mapRect(lay.seatRect(seat)).toAlignedRect().adjusted(-3, -3, 3, 3);
+}
+
+void NavigationCanvas::setHover(int seat){
+    if (seat == m_hoverSeat) return;
+    update(seatDamageRect(m_hoverSeat));
+    m_hoverSeat = seat;
+    update(seatDamageRect(m_hoverSeat));
+    emit seatHovered(seat);
+}
+
+void NavigationCanvas::setSeatSelected(int seat, bool on){
+    if (seat < 0 || seat >= m_selected.size() || bool(m_selected.at(seat)) == on) return;
+    m_selected[seat] = on ? 1 : 0;
+    if (on) m_selectedIds.append(seat);
+    else    m_selectedIds.removeOne(seat);
+    refreshFragment(seat);
+    update(seatDamageRect(seat));
+}
+
+void NavigationCanvas::resetSelection(){
+    for (int id : std::as_const(m_selectedIds)) {
+        m_selected[id] = 0;
+        refreshFragment(id);
+        update(seatDamageRect(id));
+    }
+    m_selectedIds.clear();
 }
 
-void NavigationCanvas::drawBackgroundGrid(QPainter& p){
+void NavigationCanvas::clearSelection(){
+    if (m_selectedIds.isEmpty()) return;
+    resetSelection();
+    emit selectionChanged(0);
+}
+
+void NavigationCanvas::setSeatState(int id, SeatState s){
+    if (!SeatLayout::isValidKey(id) || s == SeatState::Selected || seatState(id) == s) return;
+    if (s == SeatState::Free) m_seatById.remove(id);
+    else                      m_seatById.insert(id, quint8(s));
+
+    const int seat = lay.indexOf(id);
+    if (seat < 0) return;       // 当前布局没排到：只记状态
+    applySeatCrowd(seat, crowdWeight(s) - crowdWeight(SeatState(m_seatState.at(seat))));
+    m_seatState[seat] = quint8(s);
+    refreshFragment(seat);
+    update(seatDamageRect(seat));
+    m_replanTimer.start();      // 一批状态更新合并成一次增量修复
+}
+
+/* ---------- 座位精灵 ---------- */
+void NavigationCanvas::ensureSeatSprites(){
+    // 图集按屏幕尺寸（座位 × 缩放）光栅化，放大后依然清晰
+    const qreal  dpr      = devicePixelRatioF();
+    const bool   ss       = superSampleFactor() > 1.0;
+    const bool   detailed = seatScreenWidth() >= kSeatOutlineMinPx;
+    const QSizeF size     = lay.seatSize * m_zoom;
+    const qreal  radius   = lay.prm.seatRadius * m_zoom;
+    if (!m_atlas.matches(size, radius, dpr, ss, detailed)) {
+        m_atlas.rebuild(size, radius, dpr, ss, detailed);
+        m_fragmentsDirty = true;
+    }
+    if (!m_fragmentsDirty) return;
+    m_fragmentsDirty = false;
+
+    // 片段坐标为精灵中心（世界坐标）；源矩形是设备像素，
+    // 按 1/(dpr×缩放) 缩放后经视图变换恰好一比一落到屏幕像素
+    const int n = lay.seatCount();
+    const qreal inv = 1.0 / (m_atlas.dpr() * m_zoom);
+    const qreal hw = lay.seatSize.width() / 2, hh = lay.seatSize.height() / 2;
+    m_seatFragments.resize(n);
+    for (int i = 0; i < n; ++i)
+        m_seatFragments[i] = QPainter::PixmapFragment::create(
+            QPointF(lay.seatX.at(i) + hw, lay.seatY.at(i) + hh),
+            m_atlas.sourceRect(visualState(i)), inv, inv);
+}
+
+void NavigationCanvas::refreshFragment(int seat){
+    if (m_fragmentsDirty || seat < 0 || seat >= m_seatFragments.size()) return;
+    const QRectF src = m_atlas.sourceRect(visualState(seat));
+    m_seatFragments[seat].sourceLeft = src.left();
+    m_seatFragments[seat].sourceTop  = src.top();
+}
+
+void NavigationCanvas::mousePressEvent(QMouseEvent* e){
+    if (e->button() == Qt::LeftButton) {
+        m_pressed  = true;
+        m_pressPos = e->position().toPoint();
+        m_rubber   = QRect();
+    } else if (e->button() == Qt::RightButton || e->button() == Qt::MiddleButton) {
+        m_panning = true;
+        m_panLast = e->position().toPoint();
+        setCursor(Qt::ClosedHandCursor);
+    }
+    QWidget::mousePressEvent(e);
+}
+
+void NavigationCanvas::mouseDoubleClickEvent(QMouseEvent* e){
+    // 右键/中键双击：复位视图
+    if (e->button() == Qt::RightButton || e->button() == Qt::MiddleButton) { resetView(); return; }
+    QWidget::mouseDoubleClickEvent(e);
+}
+
+void NavigationCanvas::wheelEvent(QWheelEvent* e){
+    // 一格滚轮（120）约 1.2 倍；触控板的细粒度增量同样连续
+    const int delta = e->angleDelta().y();
+    if (delta == 0) { QWidget::wheelEvent(e); return; }
+    zoomAt(e->position(), qPow(1.2, delta / 120.0));
+    e->accept();
+}
+
+void NavigationCanvas::mouseMoveEvent(QMouseEvent* e){
+    const QPoint pos = e->position().toPoint();
+    if (m_panning) {
+        setView(m_zoom, m_pan + QPointF(pos - m_panLast));
+        m_panLast = pos;
+    }
+    setHover(m_index.seatAt(toWorld(pos)));
+
+    // 按住左键拖出一定距离后进入框选
+    if (m_pressed && e->buttons().testFlag(Qt::LeftButton)
+        && (m_rubber.isValid() || (pos - m_pressPos).manhattanLength() > 4)) {
+        const QRect old = m_rubber;
+        m_rubber = QRect(m_pressPos, pos).normalized();
+        update((old | m_rubber).adjusted(-2, -2, 2, 2));
+    }
+    QWidget::mouseMoveEvent(e);
+}
+
+void NavigationCanvas::mouseReleaseEvent(QMouseEvent* e){
+    if (m_panning && (e->button() == Qt::RightButton || e->button() == Qt::MiddleButton)) {
+        m_panning = false;
+        unsetCursor();
+    }
+    if (e->button() != Qt::LeftButton || !m_pressed) { QWidget::mouseReleaseEvent(e); return; }
+    m_pressed = false;
+    const bool additive = e->modifiers().testFlag(Qt::ControlModifier);
+
+    if (m_rubber.isValid()) {
+        // 框选：Ctrl 追加，否则替换
+        QVector<int> hits;
+        m_index.seatsIn(m_viewInv.mapRect(QRectF(m_rubber)), hits);
+        if (!additive) resetSelection();
+        for (int id : std::as_const(hits)) setSeatSelected(id, true);
+        update(m_rubber.adjusted(-2, -2, 2, 2));
+        m_rubber = QRect();
+    } else {
+        // 点选：Ctrl 切换，否则单选；点空白清空
+        const int seat = m_index.seatAt(toWorld(e->position()));
+        if (additive) {
+            if (seat >= 0) setSeatSelected(seat, !m_selected.at(seat));
+        } else {
+            resetSelection();
+            if (seat >= 0) setSeatSelected(seat, true);
+        }
+    }
+    emit selectionChanged(m_selectedIds.size());
+    QWidget::mouseReleaseEvent(e);
+}
+
+void NavigationCanvas::leaveEvent(QEvent* e){
+    setHover(-1);
+    QWidget::leaveEvent(e);
+}
+
+void NavigationCanvas::drawBackgroundGrid(QPainter& p, const SeatLayout& lay, qreal zoom, const QRectF& vis){
     // 背景渐变
     QLinearGradient g(0, 0, 0, lay.H);
     g.setColorAt(0.0, QColor(10,14,24));
     g.setColorAt(1.0, QColor(16,19,27));
-    p.fillRect(QRect(0,0,lay.W,lay.H), g);
+    p.fillRect(vis, g);
 
     p.setRenderHint(QPainter::Antialiasing, true);
 
@@ -65,53 +518,53 @@ void NavigationCanvas::drawBackgroundGrid(QPainter& p){
     p.setPen(inner);
     p.drawRoundedRect(lay.rectInner.adjusted(6, 6, -6, -6), 10, 10);
 
-    // —— 主网格：对齐 m_cell，并每 4 格一条稍亮的分区线 —— //
-    const int cell = m_cell;
-    // 网格范围贴着内圈边框：以 lay.rectInner 为准
-    const int Lg = snapUp(lay.rectInner.left(),  cell);
-    const int Tg = snapUp(lay.rectInner.top(),   cell);
-    const int Rg = snapDn(lay.rectInner.right(), cell);
-    const int Bg = snapDn(lay.rectInner.bottom(),cell);
-
-    QPen minorPen(QColor(70, 86,108, 70));  minorPen.setWidth(1);
-    QPen majorPen(QColor(100,120,140,120)); majorPen.setWidth(1);
-
-    for (int x = Lg, idx = 0; x <= Rg; x += cell, ++idx) {
+    // —— 主网格：对齐 cell，并每 4 格一条稍亮的分区线 —— //
+    const int cell = lay.prm.cell;
+    if (cell <= 0) return;
+    // 网格范围贴着内圈边框：以 lay.gridRect 为准
+    const int Lg = lay.gridRect.left();
+    const int Tg = lay.gridRect.top();
+    const int Rg = Lg + lay.gridCols * cell;
+    const int Bg = Tg + lay.gridRows * cell;
+
+    // 只遍历可见的行列；线段也裁到可见范围，代价与窗口面积相关而与楼层大小无关
+    const int c0 = qMax(0, qFloor((vis.left() - Lg) / cell));
+    const int c1 = qMin(lay.gridCols, qCeil((vis.right() - Lg) / cell));
+    const int r0 = qMax(0, qFloor((vis.top() - Tg) / cell));
+    const int r1 = qMin(lay.gridRows, qCeil((vis.bottom() - Tg) / cell));
+    const qreal y0 = qMax<qreal>(Tg, vis.top()),  y1 = qMin<qreal>(Bg, vis.bottom());
+    const qreal x0 = qMax<qreal>(Lg, vis.left()), x1 = qMin<qreal>(Rg, vis.right());
+
+    // 线宽按屏幕像素（cosmetic），缩放不改变粗细；格子太小时细线省略
+    const bool minor = cell * zoom >= kMinorGridMinPx;
+    QPen minorPen(QColor(70, 86,108, 70));  minorPen.setWidth(1); minorPen.setCosmetic(true);
+    QPen majorPen(QColor(100,120,140,120)); majorPen.setWidth(1); majorPen.setCosmetic(true);
+
+    for (int idx = c0; idx <= c1; ++idx) {
+        if (idx % 4 != 0 && !minor) continue;
+        const qreal x = Lg + idx * cell;
         p.setPen(idx % 4 == 0 ? majorPen : minorPen);
-        p.drawLine(x, Tg, x, Bg);
+        p.drawLine(QPointF(x, y0), QPointF(x, y1));
     }
-    for (int y = Tg, idy = 0; y <= Bg; y += cell, ++idy) {
+    for (int idy = r0; idy <= r1; ++idy) {
+        if (idy % 4 != 0 && !minor) continue;
+        const qreal y = Tg + idy * cell;
         p.setPen(idy % 4 == 0 ? majorPen : minorPen);
-        p.drawLine(Lg, y, Rg, y);
+        p.drawLine(QPointF(x0, y), QPointF(x1, y));
     }
 }
 
 
-void NavigationCanvas::drawShelvesLabels(QPainter& p){
-    const int cell = m_cell;
+void NavigationCanvas::drawShelvesLabels(QPainter& p, const SeatLayout& lay, const QRectF& vis){
+    static const char* const labels[] = { "A", "B", "C", "D" };
 
-    // 统一尺寸：宽 4 格，高 2 格；完全贴网格
-    const int badgeW = 4 * cell;
-    const int badgeH = 2 * cell;
+    QFont f = p.font(); f.setBold(true);
+    f.setPointSizeF(qMax(10.0, lay.H*0.022));
+    p.setFont(f);
 
-    // 纵向位置：在内圈网格顶部往下 1 格（不挡座位），并贴网格
-    const int Tg = snapUp(lay.rectInner.top(), cell);
-    const int y  = Tg + cell; // 下移 1 格
-
-    const QString labels[4] = {u8"A",u8"B",u8"C",u8"D"};
-    const int n = 4;
-    const int colW = lay.rectInner.width() / n;
-
-    for (int i = 0; i < n; ++i) {
-        // 以分栏中心为基准，再对齐到网格，并确保不越界
-        const int cx = lay.rectInner.left() + colW * i + colW / 2;
-        int left = snapDn(cx - badgeW/2, cell);
-        // clamp 到边界内（左右各留 2px 缓冲）
-        left = qMax(left, lay.rectInner.left() + 2);
-        if (left + badgeW > lay.rectInner.right() - 2)
-            left = lay.rectInner.right() - 2 - badgeW;
-
-        QRect r(left, y, badgeW, badgeH);
+    for (int i = 0; i < lay.shelfRects.size() && i < 4; ++i) {
+        const QRect& r = lay.shelfRects.at(i);
+        if (!vis.intersects(QRectF(r))) continue;
 
         // 背板
         p.setPen(QPen(QColor(55,67,85), 1));
@@ -120,90 +573,41 @@ void NavigationCanvas::drawShelvesLabels(QPainter& p){
 
         // 文本
         p.setPen(QColor(224,229,236));
-        QFont f = p.font(); f.setBold(true);
-        f.setPointSizeF(qMax(10.0, lay.H*0.022));
-        p.setFont(f);
-        p.drawText(r, Qt::AlignCenter, labels[i]);
+        p.drawText(r, Qt::AlignCenter, QLatin1String(labels[i]));
     }
 }
 
 
-void NavigationCanvas::drawSeats(QPainter& p){
-    const int cell = m_cell;
-
-    // —— 可铺设的网格区域（对齐网格），顶部为标签预留 m_topReserve 格 —— //
-    const int Lg = snapUp(lay.rectInner.left(),  cell);
-    const int Tg = snapUp(lay.rectInner.top(),   cell);
-    const int Rg = snapDn(lay.rectInner.right(), cell);
-    const int Bg = snapDn(lay.rectInner.bottom(),cell);
+void NavigationCanvas::drawSeats(QPainter& p, const QRectF& vis){
+    if (m_seatFragments.isEmpty() || m_atlas.pixmap().isNull()) return;
 
-    const int L_area = Lg;                           // 网格对齐的左界
-    const int T_area = Tg + m_topReserve * cell;     // 顶部留白后
-    const int R_area = Rg;
-    const int B_area = Bg;
-
-    // —— 座位尺寸与步进 —— //
-    const int seatW = m_seatCols * cell;             // 4 格
-    const int seatH = m_seatRows * cell;             // 2 格
-    const int stepX = seatW + m_aisleXCells * cell;  // 普通过道
-    const int stepY = seatH + m_aisleYCells * cell;
-
-    // 简化的座位布局算法
-    // 1) 计算可用的总宽度和高度
-    const int availableWidth = R_area - L_area - 2;  // 减去右边预留的2px
-    const int availableHeight = B_area - T_area - 2; // 减去底部预留的2px
-
-    // 2) 计算可以容纳的列数和行数
-    const int maxCols = (availableWidth + m_aisleXCells * cell) / (stepX);
-    const int maxRows = (availableHeight + m_aisleYCells * cell) / (stepY);
-
-    // 确保至少1列1行
-    const int numCols = qMax(1, maxCols);
-    const int numRows = qMax(1, maxRows);
-
-    // 3) 计算总内容宽度和高度
-    const int totalContentWidth = numCols * stepX - m_aisleXCells * cell;
-    const int totalContentHeight = numRows * stepY - m_aisleYCells * cell;
-
-    // 4) 计算起始位置，确保水平居中且最左边的座位距离左边框2px
-    const int startX = L_area + 2;  // 左边距2px
-    const int startY = T_area + (availableHeight - totalContentHeight) / 2; // 垂直居中
-
-    // 5) 生成所有座位位置
-    QVector<int> xs, ys;
-    for (int col = 0; col < numCols; ++col) {
-        xs.push_back(startX + col * stepX);
-    }
-    for (int row = 0; row < numRows; ++row) {
-        ys.push_back(startY + row * stepY);
-    }
-
-    // 删除最左边和最右边的一列
-    if (xs.size() > 2) {
-        xs.removeFirst();  // 删除最左边一列
-        xs.removeLast();   // 删除最右边一列
+    // 整层可见时一次贴出全部；否则经空间索引只取视口内的座位
+    const bool all = vis.contains(lay.seatBounds());
+    if (all) {
+        p.drawPixmapFragments(m_seatFragments.constData(), m_seatFragments.size(), m_atlas.pixmap());
+    } else {
+        m_visibleSeats.clear();
+        m_index.seatsIn(vis, m_visibleSeats);
+        m_visibleFragments.resize(m_visibleSeats.size());
+        for (int k = 0; k < m_visibleSeats.size(); ++k)
+            m_visibleFragments[k] = m_seatFragments.at(m_visibleSeats.at(k));
+        p.drawPixmapFragments(m_visibleFragments.constData(), m_visibleFragments.size(), m_atlas.pixmap());
     }
 
-    if (xs.isEmpty() || ys.isEmpty()) return;
-
-    // —— 绘制座位 —— //
-    QPen seatPen(QColor(130, 160, 180, 110));
-    seatPen.setWidthF(1.2);
-
-    for (int y : ys) {
-        for (int x : xs) {
-            QRectF seatRect(x + m_seatGap, y + m_seatGap,
-                            seatW - 2*m_seatGap, seatH - 2*m_seatGap);
-
-            p.setPen(Qt::NoPen);
-            p.setBrush(QColor(26,34,48,220));
-            p.drawRoundedRect(seatRect, m_seatRadius, m_seatRadius);
+    if (seatScreenWidth() >= kSeatLabelMinPx) drawSeatLabels(p, all);
+}
 
-            p.setBrush(Qt::NoBrush);
-            p.setPen(seatPen);
-            p.drawRoundedRect(seatRect, m_seatRadius, m_seatRadius);
-        }
+void NavigationCanvas::drawSeatLabels(QPainter& p, bool all){
+    // 只有放大后才会走到这里，可见座位数量有限
+    if (all) {
+        m_visibleSeats.resize(lay.seatCount());
+        for (int i = 0; i < lay.seatCount(); ++i) m_visibleSeats[i] = i;
     }
+    if (m_visibleSeats.isEmpty()) return;
+    QFont f = p.font(); f.setPointSizeF(qMax(6.0, lay.seatSize.height() * 0.35)); p.setFont(f);
+    p.setPen(QColor(203,213,225,200));
+    for (int i : std::as_const(m_visibleSeats))
+        p.drawText(lay.seatRect(i), Qt::AlignCenter, QString::number(lay.seatId.at(i)));
 }
 
 
@@ -215,34 +619,108 @@ void NavigationCanvas::drawStartMark(QPainter& p){
 
     p.setPen(QColor(200,225,240));
     QFont f = p.font(); f.setBold(true); f.setPointSizeF(qMax(9.0, lay.H*0.018)); p.setFont(f);
-    p.drawText(lay.startPt + QPoint(12, -6), "START");
+    p.drawText(lay.startPt + QPoint(12, -6), QStringLiteral("START"));
+}
+
+QRectF NavigationCanvas::startMarkBounds() const {
+    // 圆点半径 + 右上方 "START" 文字，留足余量
+    const qreal r = 0.012 * qMin(lay.W, lay.H);
+    const qreal fs = qMax(9.0, lay.H*0.018) * 2.0;
+    return QRectF(lay.startPt.x() - r - 2, lay.startPt.y() - 6 - fs,
+                  r + 16 + fs * 4, r + 8 + fs);
 }
 
-void NavigationCanvas::drawScene(QPainter& p, const QSize&){
-    drawBackgroundGrid(p);  // 主网格（带每 4 格一条分界线）
-    drawShelvesLabels(p);   // A/B/C/D
-    drawSeats(p);           // 4×2 座位 + 走道
-    drawStartMark(p);       // 右下角对齐到网格
+void NavigationCanvas::drawRoute(QPainter& p, const QRectF& dirty){
+    if (m_routePath.isEmpty() || !m_routeBounds.intersects(dirty)) return;
+
+    QPen pen(QColor(56,189,248,220));
+    pen.setWidthF(3.0);
+    pen.setCapStyle(Qt::RoundCap);
+    pen.setJoinStyle(Qt::RoundJoin);
+    p.setPen(pen);
+    p.setBrush(Qt::NoBrush);
+    p.drawPath(m_routePath);
+
+    m_glow.draw(p, m_zoom, devicePixelRatioF());   // 光晕与粒子叠在线上
 }
 
-void NavigationCanvas::paintEvent(QPaintEvent*){
-    if (useSSAA) {
-        if (msaaBuffer.size() != QSize(width()*2, height()*2))
-            msaaBuffer = QImage(width()*2, height()*2, QImage::Format_RGBA8888);
-        msaaBuffer.fill(Qt::transparent);
+void NavigationCanvas::drawSelection(QPainter& p){
+    // 选中态已由座位精灵表现，这里只画悬停
+    const qreal rr = lay.prm.seatRadius;
+    if (m_hoverSeat >= 0) {
+        QPen pen(QColor(226,232,240,200), 1.4);
+        pen.setCosmetic(true);
+        p.setPen(pen);
+        p.setBrush(QColor(255,255,255,22));
+        p.drawRoundedRect(lay.seatRect(m_hoverSeat), rr, rr);
+    }
+}
 
-        QPainter pm(&msaaBuffer);
-        pm.setRenderHint(QPainter::Antialiasing, true);
-        pm.scale(2.0, 2.0);
-        drawScene(pm, QSize(width(), height()));
-        pm.end();
+void NavigationCanvas::drawRubberBand(QPainter& p){
+    if (!m_rubber.isValid()) return;
+    QPen pen(QColor(148,163,184,220));
+    pen.setStyle(Qt::DashLine);
+    p.setPen(pen);
+    p.setBrush(QColor(56,189,248,28));
+    p.drawRect(QRectF(m_rubber).adjusted(0.5, 0.5, -0.5, -0.5));
+}
 
-        QPainter p(this);
-        p.setRenderHint(QPainter::SmoothPixmapTransform, true);
-        p.drawImage(rect(), msaaBuffer);
-    } else {
-        QPainter p(this);
-        p.setRenderHint(QPainter::Antialiasing, true);
-        drawScene(p, size());
+void NavigationCanvas::drawScene(QPainter& p, const SeatLayout& lay, qreal zoom, const QRectF& vis){
+    drawBackgroundGrid(p, lay, zoom, vis);  // 主网格（带每 4 格一条分界线）
+    drawShelvesLabels(p, lay, vis);         // A/B/C/D
+}
+
+void NavigationCanvas::drawOverlays(QPainter& p, const QRectF& dirty){
+    drawSelection(p);       // 悬停
+    drawRoute(p, dirty);    // 当前路径（在标记之下）
+    if (startMarkBounds().intersects(dirty))
+        drawStartMark(p);   // 右下角对齐到网格
+}
+
+void NavigationCanvas::rebuildScene(){
+    m_staticDirty = false;
+    // 布局按值捕获（隐式共享，写时复制），工作线程只读这份快照
+    const SeatLayout snapshot = lay;
+    m_tiles.setScene([snapshot](QPainter& p, const QRectF& world, qreal zoom){
+        drawScene(p, snapshot, zoom, world);
+    }, devicePixelRatioF());
+}
+
+void NavigationCanvas::paintEvent(QPaintEvent* e){
+    // 场景只在布局或 DPR（如拖到另一块屏幕）变化时换代
+    if (m_staticDirty || !qFuzzyCompare(m_tiles.dpr(), devicePixelRatioF()))
+        rebuildScene();
+    m_tiles.setQuality(superSampleFactor());
+
+    ensureSeatSprites();
+
+    // 损伤区域：单个座位状态变化只会带来一两个小矩形。逐个矩形裁剪后只画与之相交的瓦片和座位；
+    // 每个矩形单独设裁剪，跨矩形的半透明座位不会被叠画两次。矩形太碎时退化为包围盒。
+    const QRegion& region = e->region();
+    QVector<QRect> rects(region.begin(), region.end());
+    if (rects.size() > kMaxDamageRects) rects = { region.boundingRect() };
+
+    const QRectF visible = visibleWorldRect();
+    QPainter p(this);
+    m_tiles.beginFrame(m_zoom, m_pan);      // 帧号每次重绘只推进一次，与矩形个数无关
+    for (const QRect& r : std::as_const(rects)) {
+        p.setClipRect(r);
+        p.fillRect(r, QColor(10,14,24));    // 瓦片到位前的底色
+        m_tiles.draw(p, r);
+
+        // 世界坐标内容：座位（随实时状态变化，不进静态层）
+        p.setTransform(m_view);
+        drawSeats(p, m_viewInv.mapRect(QRectF(r)) & visible);
+        p.resetTransform();
     }
+    p.setClipping(false);   // 回到系统裁剪（整个损伤区域）
+
+    // 动态叠加层：与损伤区域不相交的直接跳过
+    p.setTransform(m_view);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    drawOverlays(p, m_viewInv.mapRect(QRectF(region.boundingRect())));
+
+    // 屏幕坐标内容
+    p.resetTransform();
+    drawRubberBand(p);
 }
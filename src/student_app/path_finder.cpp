@@ -0,0 +1,167 @@
+#include <seatui/student/path_finder.hpp>
+#include <seatui/student/nav_grid.hpp>
+#include <algorithm>
+
+namespace {
+// 堆顶为 f 最小；f 相同时优先 h 小（更靠近终点），减少平台区展开
+struct NodeGreater {
+    template <class N>
+    bool operator()(const N& a, const N& b) const {
+        return a.f != b.f ? a.f > b.f : a.h > b.h;
+    }
+};
+
+inline int sign(int v) { return (v > 0) - (v < 0); }
+
+// —— 跳点搜索（JPS，禁止切角版本） —— //
+// 直行跳跃：遇到终点或“强迫邻居”即停，撞墙返回 -1
+int jumpStraight(const NavGrid& g, int x, int y, int dx, int dy, int goal){
+    for (;;) {
+        if (!g.walkable(x, y)) return -1;
+        const int idx = g.index(x, y);
+        if (idx == goal) return idx;
+        if (dx != 0) {
+            if ((g.walkable(x, y - 1) && !g.walkable(x - dx, y - 1)) ||
+                (g.walkable(x, y + 1) && !g.walkable(x - dx, y + 1)))
+                return idx;
+        } else {
+            if ((g.walkable(x - 1, y) && !g.walkable(x - 1, y - dy)) ||
+                (g.walkable(x + 1, y) && !g.walkable(x + 1, y - dy)))
+                return idx;
+        }
+        x += dx; y += dy;
+    }
+}
+
+// 斜行跳跃：每一步都向两个分量方向做直行跳跃，有结果即成为跳点
+int jumpDiagonal(const NavGrid& g, int x, int y, int dx, int dy, int goal){
+    for (;;) {
+        if (!g.walkable(x, y)) return -1;
+        const int idx = g.index(x, y);
+        if (idx == goal) return idx;
+        if (jumpStraight(g, x + dx, y, dx, 0, goal) >= 0 ||
+            jumpStraight(g, x, y + dy, 0, dy, goal) >= 0)
+            return idx;
+        if (!g.walkable(x + dx, y) || !g.walkable(x, y + dy)) return -1;
+        x += dx; y += dy;
+    }
+}
+}
+
+void PathFinder::prepare(int cellCount){
+    if (int(g_.size()) != cellCount) {
+        g_.assign(size_t(cellCount), 0);
+        parent_.assign(size_t(cellCount), -1);
+        seen_.assign(size_t(cellCount), 0);
+        closed_.assign(size_t(cellCount), 0);
+        gen_ = 0;
+    }
+    if (++gen_ == 0) {   // 代次回绕：整体清一次
+        std::fill(seen_.begin(), seen_.end(), 0);
+        std::fill(closed_.begin(), closed_.end(), 0);
+        gen_ = 1;
+    }
+    open_.clear();
+    expanded_ = 0;
+}
+
+NavRoute PathFinder::find(const NavGrid& grid, const QPoint& from, const QPoint& to){
+    NavRoute route;
+    if (grid.isEmpty() || !grid.walkable(from) || !grid.walkable(to)) return route;
+
+    prepare(grid.cellCount());
+    const int start = grid.index(from.x(), from.y());
+    const int goal  = grid.index(to.x(), to.y());
+
+    g_[size_t(start)] = 0;
+    parent_[size_t(start)] = -1;
+    seen_[size_t(start)] = gen_;
+    const quint32 h0 = octile(to.x() - from.x(), to.y() - from.y());
+    open_.push_back({ h0, h0, start });
+
+    const NodeGreater cmp;
+    bool found = false;
+    while (!open_.empty()) {
+        std::pop_heap(open_.begin(), open_.end(), cmp);
+        const Node cur = open_.back();
+        open_.pop_back();
+        if (closed_[size_t(cur.idx)] == gen_) continue;   // 过期副本
+        closed_[size_t(cur.idx)] = gen_;
+        ++expanded_;
+        if (cur.idx == goal) { found = true; break; }
+
+        const int cx = cur.idx % grid.cols();
+        const int cy = cur.idx / grid.cols();
+        const quint32 gc = g_[size_t(cur.idx)];
+
+        // —— 邻居剪枝：起点展开 8 方向，其余按来向只保留自然/强迫邻居 —— //
+        int dirs[8][2];
+        int nd = 0;
+        const int par = parent_[size_t(cur.idx)];
+        if (par < 0) {
+            static const int ALL[8][2] = { {1,0},{-1,0},{0,1},{0,-1},{1,1},{1,-1},{-1,1},{-1,-1} };
+            for (const auto& d : ALL) { dirs[nd][0] = d[0]; dirs[nd][1] = d[1]; ++nd; }
+        } else {
+            const int dx = sign(cx - par % grid.cols());
+            const int dy = sign(cy - par / grid.cols());
+            auto push = [&](int ax, int ay){ dirs[nd][0] = ax; dirs[nd][1] = ay; ++nd; };
+            if (dx != 0 && dy != 0) {
+                push(0, dy);
+                push(dx, 0);
+                push(dx, dy);
+            } else if (dx != 0) {
+                push(dx, 0);
+                push(dx, 1);  push(dx, -1);
+                push(0, 1);   push(0, -1);
+            } else {
+                push(0, dy);
+                push(1, dy);  push(-1, dy);
+                push(1, 0);   push(-1, 0);
+            }
+        }
+
+        for (int k = 0; k < nd; ++k) {
+            const int dx = dirs[k][0], dy = dirs[k][1];
+            const int nx = cx + dx, ny = cy + dy;
+            if (!grid.walkable(nx, ny)) continue;
+            // 斜行需两侧直行格都可走，避免贴着座位角穿过
+            if (dx != 0 && dy != 0 && (!grid.walkable(nx, cy) || !grid.walkable(cx, ny))) continue;
+
+            const int jp = (dx != 0 && dy != 0) ? jumpDiagonal(grid, nx, ny, dx, dy, goal)
+                                                : jumpStraight(grid, nx, ny, dx, dy, goal);
+            if (jp < 0 || closed_[size_t(jp)] == gen_) continue;
+
+            const int jx = jp % grid.cols(), jy = jp / grid.cols();
+            const quint32 ng = gc + octile(jx - cx, jy - cy);
+            if (seen_[size_t(jp)] == gen_ && ng >= g_[size_t(jp)]) continue;
+
+            seen_[size_t(jp)]   = gen_;
+            g_[size_t(jp)]      = ng;
+            parent_[size_t(jp)] = cur.idx;
+            const quint32 h = octile(to.x() - jx, to.y() - jy);
+            open_.push_back({ ng + h, h, jp });
+            std::push_heap(open_.begin(), open_.end(), cmp);
+        }
+    }
+    if (!found) return route;
+
+    // —— 跳点之间是直线/45° 线段，逐格展开成完整路径 —— //
+    route.cost = g_[size_t(goal)];
+    QVector<QPoint> jumps;
+    for (int i = goal; i >= 0; i = parent_[size_t(i)])
+        jumps.append(grid.cellOf(i));
+    std::reverse(jumps.begin(), jumps.end());
+
+    route.cells.reserve(int(route.cost / kStraight) + 2);
+    route.cells.append(jumps.first());
+    for (int i = 1; i < jumps.size(); ++i) {
+        QPoint c = jumps.at(i - 1);
+        const QPoint e = jumps.at(i);
+        const int sx = sign(e.x() - c.x()), sy = sign(e.y() - c.y());
+        while (c != e) {
+            c += QPoint(sx, sy);
+            route.cells.append(c);
+        }
+    }
+    return route;
+}
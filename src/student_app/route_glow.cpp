@@ -0,0 +1,224 @@
+#include <seatui/student/route_glow.hpp>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QRadialGradient>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr qreal kCoreWidth   = 6.0;    // 光晕芯线宽（世界坐标）
+constexpr qreal kGlowRadius  = 7.0;    // 模糊半径（世界坐标）
+constexpr qreal kParticleDia = 7.0;    // 粒子直径（世界坐标）
+constexpr int   kSpriteSide  = 24;     // 粒子精灵边长（逻辑像素）
+constexpr int   kMaxGlowSide = 2048;   // 光晕精灵最长边
+
+// 沿一行/一列做一次盒式模糊（预乘 ARGB，四通道同时滑窗；窗外视为透明）
+void boxBlurLine(quint32* data, int n, int stride, int r, std::vector<quint32>& tmp){
+    tmp.resize(size_t(n));
+    for (int i = 0; i < n; ++i) tmp[size_t(i)] = data[size_t(i) * stride];
+
+    int a = 0, rr = 0, g = 0, b = 0;
+    auto add = [&](quint32 px, int sign){
+        a  += sign * int(px >> 24);
+        rr += sign * int((px >> 16) & 0xff);
+        g  += sign * int((px >> 8) & 0xff);
+        b  += sign * int(px & 0xff);
+    };
+    for (int i = 0; i <= r && i < n; ++i) add(tmp[size_t(i)], 1);
+
+    const int w = 2 * r + 1;
+    for (int i = 0; i < n; ++i) {
+        data[size_t(i) * stride] = quint32(a / w) << 24 | quint32(rr / w) << 16
+                                 | quint32(g / w) << 8  | quint32(b / w);
+        if (i + r + 1 < n) add(tmp[size_t(i + r + 1)], 1);
+        if (i - r >= 0)    add(tmp[size_t(i - r)], -1);
+    }
+}
+
+// 横竖各两遍盒式模糊，近似高斯
+void boxBlur(QImage& img, int r){
+    if (r <= 0) return;
+    const int W = img.width(), H = img.height();
+    const int stride = img.bytesPerLine() / 4;
+    quint32* bits = reinterpret_cast<quint32*>(img.bits());
+    std::vector<quint32> tmp;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int y = 0; y < H; ++y) boxBlurLine(bits + size_t(y) * stride, W, 1, r, tmp);
+        for (int x = 0; x < W; ++x) boxBlurLine(bits + x, H, stride, r, tmp);
+    }
+}
+}
+
+void RouteGlow::setPath(const QPainterPath& path){
+    path_   = path;
+    glow_   = QPixmap();
+    glowZoom_ = 0;
+    length_ = 0;
+    bounds_ = QRectF();
+    if (path.isEmpty()) { count_ = 0; return; }
+
+    buildArcTable();
+    if (length_ <= 0) { count_ = 0; return; }
+
+    const qreal pad = kCoreWidth / 2 + 2 * kGlowRadius;
+    bounds_ = path.boundingRect().adjusted(-pad, -pad, pad, pad);
+
+    s_.assign(kMaxParticles, 0.f);
+    v_.assign(kMaxParticles, 0.f);
+    phase_.assign(kMaxParticles, 0.f);
+    const int n = count_ > 0 ? count_ : kMaxParticles / 2;   // 沿用预算调整后的数量
+    count_ = 0;
+    spawn(0, n);
+}
+
+void RouteGlow::buildArcTable(){
+    px_.clear(); py_.clear(); cum_.clear();
+    const QList<QPolygonF> polys = path_.toSubpathPolygons();   // 曲线被展平为折线
+    float acc = 0;
+    for (const QPolygonF& poly : polys) {
+        for (const QPointF& pt : poly) {
+            if (!px_.empty()) {
+                const float dx = float(pt.x()) - px_.back(), dy = float(pt.y()) - py_.back();
+                const float d  = std::sqrt(dx * dx + dy * dy);
+                if (d <= 1e-4f) continue;
+                acc += d;
+            }
+            px_.push_back(float(pt.x()));
+            py_.push_back(float(pt.y()));
+            cum_.push_back(acc);
+        }
+    }
+    length_ = acc;
+}
+
+void RouteGlow::spawn(int from, int to){
+    auto* rng = QRandomGenerator::global();
+    for (int i = from; i < to; ++i) {
+        s_[size_t(i)]     = float(length_ * rng->generateDouble());
+        v_[size_t(i)]     = float(55.0 + 50.0 * rng->generateDouble());   // 世界像素/秒
+        phase_[size_t(i)] = float(2 * M_PI * rng->generateDouble());
+    }
+    count_ = to;
+}
+
+void RouteGlow::advance(qreal dt){
+    if (length_ <= 0) return;
+    QElapsedTimer t; t.start();
+
+    time_ += dt;
+    // 无分支环绕：越过终点就减去整段长度
+    const float L = float(length_), d = float(dt);
+    float* s = s_.data();
+    const float* v = v_.data();
+    for (int i = 0; i < count_; ++i) {
+        float x = s[i] + v[i] * d;
+        x -= L * float(x >= L);
+        s[i] = x;
+    }
+    pendingMs_ += t.nsecsElapsed() / 1e6;
+}
+
+void RouteGlow::rebuildGlow(qreal zoom, qreal dpr){
+    glowZoom_ = zoom;
+    glowDpr_  = dpr;
+    glowRect_ = bounds_;
+
+    // 光晕本身是模糊的，半分辨率足够；再按最长边封顶
+    qreal res = zoom * dpr * 0.5;
+    res = qMin(res, kMaxGlowSide / qMax(bounds_.width(), bounds_.height()));
+    const QSize sz(qMax(1, qCeil(bounds_.width() * res)), qMax(1, qCeil(bounds_.height() * res)));
+
+    QImage img(sz, QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::transparent);
+    {
+        QPainter g(&img);
+        g.setRenderHint(QPainter::Antialiasing, true);
+        g.scale(res, res);
+        g.translate(-bounds_.topLeft());
+        QPen pen(QColor(56,189,248,210));
+        pen.setWidthF(kCoreWidth);
+        pen.setCapStyle(Qt::RoundCap);
+        pen.setJoinStyle(Qt::RoundJoin);
+        g.setPen(pen);
+        g.setBrush(Qt::NoBrush);
+        g.drawPath(path_);
+    }
+    boxBlur(img, qMax(1, qRound(kGlowRadius * res / 2)));
+    glow_ = QPixmap::fromImage(std::move(img));
+}
+
+void RouteGlow::rebuildParticleSprite(qreal dpr){
+    particleDpr_ = dpr;
+    // 按设备像素光栅化，绘制仍用逻辑坐标：高 DPI 屏上粒子不被放大发糊
+    const int side = qCeil(kSpriteSide * dpr);
+    QImage img(side, side, QImage::Format_ARGB32_Premultiplied);
+    img.setDevicePixelRatio(dpr);
+    img.fill(Qt::transparent);
+    {
+        QPainter g(&img);
+        g.setRenderHint(QPainter::Antialiasing, true);
+        QRadialGradient rg(QPointF(kSpriteSide / 2.0, kSpriteSide / 2.0), kSpriteSide / 2.0);
+        rg.setColorAt(0.0,  QColor(255,255,255,255));
+        rg.setColorAt(0.35, QColor(125,211,252,220));
+        rg.setColorAt(1.0,  QColor(56,189,248,0));
+        g.setPen(Qt::NoPen);
+        g.setBrush(rg);
+        g.drawEllipse(QRectF(0, 0, kSpriteSide, kSpriteSide));
+    }
+    particle_ = QPixmap::fromImage(std::move(img));
+}
+
+void RouteGlow::draw(QPainter& p, qreal zoom, qreal dpr){
+    if (length_ <= 0) return;
+    QElapsedTimer t; t.start();
+
+    // —— 光晕：一张预模糊精灵，呼吸式透明度 —— //
+    if (glow_.isNull() || !qFuzzyCompare(glowZoom_, zoom) || !qFuzzyCompare(glowDpr_, dpr))
+        rebuildGlow(zoom, dpr);
+    const qreal opacity = p.opacity();
+    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    p.setOpacity(opacity * (0.8 + 0.2 * std::sin(time_ * 2 * M_PI * 0.6)));
+    p.drawPixmap(glowRect_, glow_, QRectF(QPointF(), QSizeF(glow_.size())));
+    p.setOpacity(opacity);
+
+    // —— 粒子：按弧长查表得位置，一次批量贴出 —— //
+    if (particle_.isNull() || !qFuzzyCompare(particleDpr_, dpr))
+        rebuildParticleSprite(dpr);
+    // 片段的源矩形按位图像素计，缩放比相应除掉 DPR
+    const QRectF src(0, 0, particle_.width(), particle_.height());
+    const qreal scale = kParticleDia / src.width();
+    const float tw = float(time_ * 3.0);
+    fragments_.resize(count_);
+    for (int i = 0; i < count_; ++i) {
+        const float s = s_[size_t(i)];
+        const size_t k = size_t(std::upper_bound(cum_.begin(), cum_.end(), s) - cum_.begin());
+        const size_t a = k == 0 ? 0 : qMin(k - 1, cum_.size() - 2);
+        const float seg = cum_[a + 1] - cum_[a];
+        const float u   = seg > 0 ? (s - cum_[a]) / seg : 0.f;
+        const qreal x = px_[a] + u * (px_[a + 1] - px_[a]);
+        const qreal y = py_[a] + u * (py_[a + 1] - py_[a]);
+        fragments_[i] = QPainter::PixmapFragment::create(QPointF(x, y), src, scale, scale, 0,
+                                                         0.55 + 0.45 * std::sin(phase_[size_t(i)] + tw));
+    }
+    p.drawPixmapFragments(fragments_.constData(), fragments_.size(), particle_);
+
+    account(pendingMs_ + t.nsecsElapsed() / 1e6);
+}
+
+void RouteGlow::account(qreal ms){
+    pendingMs_ = 0;
+    frameMs_   = frameMs_ > 0 ? frameMs_ * 0.9 + ms * 0.1 : ms;
+    windowPeak_ = qMax(windowPeak_, ms);
+    if (++windowFrames_ < 60) return;
+
+    // 约一秒一次：按平均耗时调整粒子数
+    peakMs_ = windowPeak_;
+    windowPeak_ = 0;
+    windowFrames_ = 0;
+    if (frameMs_ > kBudgetMs && count_ > 16)
+        count_ /= 2;
+    else if (frameMs_ < kBudgetMs * 0.5 && count_ < kMaxParticles)
+        spawn(count_, qMin(kMaxParticles, count_ + 16));
+}
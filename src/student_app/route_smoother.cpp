@@ -0,0 +1,69 @@
+#include <seatui/student/route_smoother.hpp>
+#include <seatui/student/nav_grid.hpp>
+#include <QtMath>
+
+bool RouteSmoother::lineOfSight(const NavGrid& grid, const QPoint& a, const QPoint& b){
+    // 格心到格心的超覆盖遍历：每步比较下一条竖/横格线谁先到，
+    // 恰好穿过格角时两侧格都要可走（与寻路“禁止切角”一致）
+    const int nx = qAbs(b.x() - a.x()), ny = qAbs(b.y() - a.y());
+    const int sx = b.x() > a.x() ? 1 : -1, sy = b.y() > a.y() ? 1 : -1;
+    int x = a.x(), y = a.y();
+    for (int ix = 0, iy = 0; ix < nx || iy < ny; ) {
+        const qint64 lhs = qint64(1 + 2 * ix) * ny, rhs = qint64(1 + 2 * iy) * nx;
+        if (lhs == rhs) {
+            if (!grid.walkable(x + sx, y) || !grid.walkable(x, y + sy)) return false;
+            x += sx; y += sy; ++ix; ++iy;
+        } else if (lhs < rhs) {
+            x += sx; ++ix;
+        } else {
+            y += sy; ++iy;
+        }
+        if (!grid.walkable(x, y)) return false;
+    }
+    return true;
+}
+
+QVector<QPoint> RouteSmoother::stringPull(const NavGrid& grid, const QVector<QPoint>& cells){
+    const int n = cells.size();
+    if (n <= 2) return cells;
+
+    // 贪心：从锚点尽量往前看，看不到第 i 格时把 i-1 定为新拐点
+    QVector<QPoint> out;
+    out.reserve(n / 4 + 2);
+    out << cells.first();
+    int anchor = 0;
+    for (int i = 2; i < n; ++i) {
+        if (i - anchor > kMaxPull || !lineOfSight(grid, cells.at(anchor), cells.at(i))) {
+            anchor = i - 1;
+            out << cells.at(anchor);
+        }
+    }
+    out << cells.last();
+    return out;
+}
+
+QPainterPath RouteSmoother::fitBezier(const QPolygonF& pts, qreal maxRadius){
+    QPainterPath path;
+    const int n = pts.size();
+    if (n == 0) return path;
+    path.moveTo(pts.first());
+    if (n == 1) return path;
+
+    // 拐角 P：在两侧各退 r 得到切点，控制点取在切点与 P 之间（圆弧近似系数 0.5523）
+    constexpr qreal kArc = 0.5523;
+    for (int i = 1; i + 1 < n; ++i) {
+        const QPointF p0 = pts.at(i - 1), p = pts.at(i), p1 = pts.at(i + 1);
+        const QPointF d0 = p - p0, d1 = p1 - p;
+        const qreal l0 = qSqrt(QPointF::dotProduct(d0, d0));
+        const qreal l1 = qSqrt(QPointF::dotProduct(d1, d1));
+        if (l0 < 1e-6 || l1 < 1e-6) continue;
+
+        const qreal r = qMin(maxRadius, qMin(l0, l1) * 0.5);
+        const QPointF u0 = d0 / l0, u1 = d1 / l1;
+        const QPointF a = p - u0 * r, b = p + u1 * r;
+        path.lineTo(a);
+        path.cubicTo(a + u0 * (r * kArc), b - u1 * (r * kArc), b);
+    }
+    path.lineTo(pts.last());
+    return path;
+}
@@ -0,0 +1,169 @@
+#include <seatui/student/scene_tile_cache.hpp>
+#include <QThread>
+#include <QtMath>
+#include <utility>
+
+SceneTileCache::SceneTileCache(QObject* parent) : QObject(parent) {
+    // 给 GUI 线程留一个核
+    pool_.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+SceneTileCache::~SceneTileCache(){
+    // 任务引用了 this（回投结果），必须在析构前全部结束
+    shared_->gen.store(~quint64(0));
+    pool_.clear();
+    pool_.waitForDone();
+}
+
+void SceneTileCache::setScene(PaintFn paint, qreal dpr){
+    paint_ = std::move(paint);
+    dpr_   = dpr;
+    ++gen_;
+    shared_->gen.store(gen_);
+    pool_.clear();              // 尚未开始的任务直接丢弃；已开始的完成后按代号丢弃
+    tiles_.clear();
+    pending_.clear();
+    bytes_ = 0;
+    fallbackZoom_ = 0.0;
+    lastComplete_ = false;
+}
+
+QImage SceneTileCache::renderTile(const PaintFn& paint, const SceneTileKey& key, qreal zoom, qreal dpr, qreal ss){
+    const int devSide = qCeil(kTileSize * dpr);
+    QImage img(qCeil(devSide * ss), qCeil(devSide * ss), QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::transparent);
+    {
+        // QPainter 画 QImage 可在任意线程进行
+        QPainter p(&img);
+        p.setRenderHint(QPainter::Antialiasing, true);
+        p.scale(dpr * ss, dpr * ss);
+        p.translate(-key.tx * kTileSize, -key.ty * kTileSize);
+        p.scale(zoom, zoom);
+        const QRectF world(QPointF(key.tx * kTileSize, key.ty * kTileSize) / zoom,
+                           QSizeF(kTileSize, kTileSize) / zoom);
+        p.setClipRect(world);
+        paint(p, world, zoom);
+    }
+    if (ss != 1.0)
+        img = img.scaled(devSide, devSide, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    img.setDevicePixelRatio(dpr);
+    return img;
+}
+
+void SceneTileCache::request(const SceneTileKey& key, qreal zoom){
+    if (!paint_ || pending_.contains(key)) return;
+    pending_.insert(key);
+
+    const quint64 gen = gen_;
+    const qreal dpr = dpr_, ss = ss_;
+    auto shared = shared_;
+    PaintFn paint = paint_;       // 快照：布局数据经隐式共享拷贝，线程安全
+    pool_.start([this, shared, paint, key, zoom, gen, dpr, ss]{
+        QImage img;
+        // 开始前再确认一次：场景换代或缩放已离开该级别则跳过，空结果只用来清除 pending
+        if (shared->gen.load() == gen && shared->zoom.load() == key.zoom)
+            img = renderTile(paint, key, zoom, dpr, ss);
+        QMetaObject::invokeMethod(this, [this, key, gen, ss, img]{
+            onTileDone(key, gen, ss, img);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void SceneTileCache::onTileDone(const SceneTileKey& key, quint64 gen, qreal ss, const QImage& img){
+    if (gen != gen_) return;      // 旧场景的结果
+    pending_.remove(key);
+    if (img.isNull()) return;
+
+    Tile& t = tiles_[key];
+    bytes_ -= qint64(t.pm.width()) * t.pm.height() * 4;
+    t.pm   = QPixmap::fromImage(img);
+    t.ss   = ss;
+    t.used = frame_;
+    bytes_ += qint64(t.pm.width()) * t.pm.height() * 4;
+    evict();
+
+    if (key.zoom == zoomKey(zoom_))
+        emit tileReady(QRect(key.tx * kTileSize, key.ty * kTileSize, kTileSize, kTileSize)
+                           .translated(pan_.toPoint()));
+}
+
+void SceneTileCache::evict(){
+    // 超出预算时按 LRU 淘汰；当前帧用到的瓦片不淘汰
+    while (bytes_ > kMaxBytes) {
+        auto victim = tiles_.end();
+        for (auto it = tiles_.begin(); it != tiles_.end(); ++it)
+            if (it->used < frame_ && (victim == tiles_.end() || it->used < victim->used)) victim = it;
+        if (victim == tiles_.end()) return;
+        bytes_ -= qint64(victim->pm.width()) * victim->pm.height() * 4;
+        tiles_.erase(victim);
+    }
+}
+
+void SceneTileCache::beginFrame(qreal zoom, const QPointF& pan){
+    ++frame_;
+    const qint64 zk = zoomKey(zoom);
+    if (zk != zoomKey(zoom_) && zoom_ > 0 && lastComplete_) fallbackZoom_ = zoom_;
+    zoom_ = zoom;
+    pan_  = pan;
+    shared_->zoom.store(zk);
+    lastComplete_ = true;       // 由本帧各次 draw 累积
+}
+
+bool SceneTileCache::draw(QPainter& p, const QRect& screen){
+    const qreal   zoom = zoom_;
+    const QPointF pan  = pan_;
+    const qint64  zk   = zoomKey(zoom);
+
+    // 屏幕区域换算到“缩放后世界”中的瓦片范围
+    const QRectF z = QRectF(screen).translated(-pan);
+    const int tx0 = qFloor(z.left() / kTileSize), tx1 = qCeil(z.right()  / kTileSize) - 1;
+    const int ty0 = qFloor(z.top()  / kTileSize), ty1 = qCeil(z.bottom() / kTileSize) - 1;
+
+    bool complete = true;
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            const SceneTileKey key{ zk, tx, ty };
+            const QPointF at(tx * kTileSize + pan.x(), ty * kTileSize + pan.y());
+            auto it = tiles_.find(key);
+            if (it != tiles_.end()) {
+                it->used = frame_;
+                p.drawPixmap(at, it->pm);
+                if (it->ss < ss_) request(key, zoom);   // 画质精修：换好之前继续用旧瓦片
+                continue;
+            }
+            complete = false;
+            request(key, zoom);
+            drawFallback(p, QRectF(at, QSizeF(kTileSize, kTileSize)), zoom, pan);
+        }
+    }
+    lastComplete_ = lastComplete_ && complete;
+    return complete;
+}
+
+bool SceneTileCache::drawFallback(QPainter& p, const QRectF& target, qreal zoom, const QPointF& pan){
+    // 缩放刚变化：用上一级缩放的瓦片拉伸顶替，避免闪出底色
+    if (fallbackZoom_ <= 0) return false;
+    const qint64 fk = zoomKey(fallbackZoom_);
+    const qreal  s  = zoom / fallbackZoom_;
+    const QRectF src = QRectF(target.translated(-pan).topLeft() / s, target.size() / s);
+    const int tx0 = qFloor(src.left() / kTileSize), tx1 = qCeil(src.right()  / kTileSize) - 1;
+    const int ty0 = qFloor(src.top()  / kTileSize), ty1 = qCeil(src.bottom() / kTileSize) - 1;
+
+    bool any = false;
+    p.save();
+    p.setClipRect(target, Qt::IntersectClip);
+    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            auto it = tiles_.find(SceneTileKey{ fk, tx, ty });
+            if (it == tiles_.end()) continue;
+            it->used = frame_;
+            const QRectF dst(QPointF(tx * kTileSize, ty * kTileSize) * s + pan,
+                             QSizeF(kTileSize, kTileSize) * s);
+            p.drawPixmap(dst, it->pm, QRectF(QPointF(), QSizeF(it->pm.size())));
+            any = true;
+        }
+    }
+    p.restore();
+    return any;
+}
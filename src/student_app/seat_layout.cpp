@@ -0,0 +1,134 @@
+#include <seatui/student/seat_layout.hpp>
+
+namespace {
+inline int snapUp(int v, int s) { return ((v + s - 1) / s) * s; }
+inline int snapDn(int v, int s) { return  (v / s) * s; }
+}
+
+SeatLayout SeatLayout::build(const Params& prm, int W, int H){
+    SeatLayout L;
+    L.prm = prm;
+    L.W = W; L.H = H;
+    L.margin = int(0.06 * qMin(W, H));
+    L.rectInner = QRect(L.margin, L.margin, W - 2*L.margin, H - 2*L.margin);
+
+    const int cell = qMax(1, prm.cell);
+    const int n    = qMax(1, prm.shelfCount);
+
+    // —— 对齐网格的区域 —— //
+    const int Lg = snapUp(L.rectInner.left(),  cell);
+    const int Tg = snapUp(L.rectInner.top(),   cell);
+    const int Rg = snapDn(L.rectInner.right(), cell);
+    const int Bg = snapDn(L.rectInner.bottom(),cell);
+    L.gridCols = qMax(0, (Rg - Lg) / cell);
+    L.gridRows = qMax(0, (Bg - Tg) / cell);
+    L.gridRect = QRect(Lg, Tg, L.gridCols * cell, L.gridRows * cell);
+
+    // START：右下角、对齐网格、离边各 2 格
+    const int rx = snapDn(L.rectInner.right(), cell)  - prm.borderCells * cell - 2*cell;
+    const int ry = snapDn(L.rectInner.bottom(), cell) - prm.borderCells * cell - 2*cell;
+    L.startPt = QPoint(rx, ry);
+
+    // —— 书架徽标：宽 4 格，高 2 格；在内圈网格顶部往下 1 格，完全贴网格 —— //
+    const int colW   = L.rectInner.width() / n;
+    const int badgeW = 4 * cell;
+    const int badgeH = 2 * cell;
+    L.shelfRects.reserve(n);
+    L.shelfZones.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        // 以分栏中心为基准，再对齐到网格，并确保不越界
+        const int cx = L.rectInner.left() + colW * i + colW / 2;
+        int left = snapDn(cx - badgeW/2, cell);
+        // clamp 到边界内（左右各留 2px 缓冲）
+        left = qMax(left, L.rectInner.left() + 2);
+        if (left + badgeW > L.rectInner.right() - 2)
+            left = L.rectInner.right() - 2 - badgeW;
+        L.shelfRects.push_back(QRect(left, Tg + cell, badgeW, badgeH));
+        L.shelfZones.push_back({ L.rectInner.left() + colW * i, L.rectInner.left() + colW * (i + 1) });
+    }
+
+    // —— 可铺设座位的区域，顶部为标签预留 topReserve 格 —— //
+    const int L_area = Lg;
+    const int T_area = Tg + prm.topReserve * cell;
+    const int R_area = Rg;
+    const int B_area = Bg;
+
+    // —— 座位尺寸与步进 —— //
+    const int seatW = prm.seatCols * cell;           // 4 格
+    const int seatH = prm.seatRows * cell;           // 2 格
+    const int stepY = seatH + prm.aisleYCells * cell;
+
+    // 1) 可用的总宽度和高度（右/下各预留 2px）
+    const int availableWidth  = R_area - L_area - 2;
+    const int availableHeight = B_area - T_area - 2;
+
+    // 2) 各列左边界：普通过道隔开，每 mainEvery 列插入一条 mainWCells 宽的主走道。
+    //    分组从第 1 列算起（第 0 列在第 4 步删掉），保证可见座位每 mainEvery 列一组
+    const int gapX  = prm.aisleXCells * cell;
+    const int mainX = qMax(prm.aisleXCells, prm.mainWCells) * cell;
+    QVector<int> colX { L_area + 2 };
+    for (;;) {
+        const int k = colX.size() - 1;                   // 刚放下的列
+        const bool main = prm.mainEvery > 0 && k >= 1 && k % prm.mainEvery == 0;
+        const int next = colX.back() + seatW + (main ? mainX : gapX);
+        if (next - colX.first() + seatW > availableWidth) break;
+        colX.push_back(next);
+    }
+    const int numCols = colX.size();
+    const int numRows = qBound(1, (availableHeight + prm.aisleYCells * cell) / stepY, kMaxRows);
+
+    // 3) 起始位置：最左边的座位距离左边框 2px，垂直居中
+    const int totalContentHeight = numRows * stepY - prm.aisleYCells * cell;
+    const int startY = T_area + (availableHeight - totalContentHeight) / 2;
+
+    // 4) 删除最左边和最右边的一列
+    int firstCol = 0, lastCol = numCols - 1;
+    if (numCols > 2) { ++firstCol; --lastCol; }
+    lastCol = qMin(lastCol, firstCol + kKeyStride - 1);     // 稳定编号容纳不下的列不排
+
+    L.seatCols = lastCol - firstCol + 1;
+    L.seatRows = numRows;
+    L.seatSize = QSizeF(seatW - 2*prm.seatGap, seatH - 2*prm.seatGap);
+
+    // —— 走道区间（主走道即更宽的列间走道，寻路网格按座位栅格化后自然留出） —— //
+    for (int c = firstCol; c < lastCol; ++c)
+        L.aisleCols.push_back({ colX.at(c) + seatW, colX.at(c + 1) });
+    for (int r = 0; r + 1 < numRows; ++r) {
+        const int y = startY + r * stepY;
+        L.aisleRows.push_back({ y + seatH, y + stepY });
+    }
+
+    // —— 5) 生成所有座位（行优先排列，编号取 排 × kKeyStride + 列） —— //
+    const int total = L.seatCols * L.seatRows;
+    L.seatId.reserve(total);
+    L.seatX.reserve(total);   L.seatY.reserve(total);
+    L.seatCol.reserve(total); L.seatRow.reserve(total);
+    L.seatZone.reserve(total);
+    for (int r = 0; r < numRows; ++r) {
+        const int y = startY + r * stepY;
+        for (int c = firstCol; c <= lastCol; ++c) {
+            const int x = colX.at(c);
+            const int zone = colW > 0 ? qBound(0, (x + seatW / 2 - L.rectInner.left()) / colW, n - 1) : 0;
+            L.seatId.push_back(seatKey(r, c - firstCol));
+            L.seatX.push_back(float(x + prm.seatGap));
+            L.seatY.push_back(float(y + prm.seatGap));
+            L.seatCol.push_back(qint16(c - firstCol));
+            L.seatRow.push_back(qint16(r));
+            L.seatZone.push_back(qint8(zone));
+        }
+    }
+    return L;
+}
+
+int SeatLayout::indexOf(int key) const {
+    if (!isValidKey(key)) return -1;
+    const int r = key / kKeyStride, c = key % kKeyStride;
+    return (r < seatRows && c < seatCols) ? r * seatCols + c : -1;
+}
+
+QRectF SeatLayout::seatBounds() const {
+    if (seatX.isEmpty()) return QRectF();
+    // 行优先生成：首个座位在左上，末个座位在右下
+    return QRectF(QPointF(seatX.first(), seatY.first()),
+                  QPointF(seatX.last() + seatSize.width(), seatY.last() + seatSize.height()));
+}
@@ -0,0 +1,92 @@
+#include <seatui/student/seat_spatial_index.hpp>
+#include <seatui/student/seat_layout.hpp>
+#include <QtMath>
+
+void SeatSpatialIndex::clear(){
+    bw_ = bh_ = 0;
+    start_.clear();
+    items_.clear();
+    x_.clear();
+    y_.clear();
+}
+
+void SeatSpatialIndex::build(const SeatLayout& layout){
+    clear();
+    const int n = layout.seatCount();
+    if (n == 0) return;
+
+    const QRectF bounds = layout.seatBounds();
+    w_ = layout.seatSize.width();
+    h_ = layout.seatSize.height();
+    x_.assign(layout.seatX.constBegin(), layout.seatX.constEnd());
+    y_.assign(layout.seatY.constBegin(), layout.seatY.constEnd());
+
+    // 桶边长取座位步距：一个点最多落在一张座位上，一个桶最多和 4 张座位相交
+    const int cell = layout.prm.cell;
+    const qreal bucketW = qMax<qreal>(1.0, (layout.prm.seatCols + layout.prm.aisleXCells) * cell);
+    const qreal bucketH = qMax<qreal>(1.0, (layout.prm.seatRows + layout.prm.aisleYCells) * cell);
+    ox_ = bounds.left();
+    oy_ = bounds.top();
+    invBucketW_ = 1.0 / bucketW;
+    invBucketH_ = 1.0 / bucketH;
+    bw_ = qMax(1, qCeil(bounds.width()  / bucketW));
+    bh_ = qMax(1, qCeil(bounds.height() / bucketH));
+
+    // —— 两遍计数建 CSR —— //
+    start_.assign(size_t(bw_) * bh_ + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        const int bx0 = bucketX(x_[size_t(i)]), bx1 = bucketX(x_[size_t(i)] + w_);
+        const int by0 = bucketY(y_[size_t(i)]), by1 = bucketY(y_[size_t(i)] + h_);
+        for (int by = by0; by <= by1; ++by)
+            for (int bx = bx0; bx <= bx1; ++bx)
+                ++start_[size_t(by * bw_ + bx) + 1];
+    }
+    for (size_t b = 1; b < start_.size(); ++b) start_[b] += start_[b - 1];
+
+    items_.resize(size_t(start_.back()));
+    std::vector<int> fill(start_.begin(), start_.end() - 1);
+    for (int i = 0; i < n; ++i) {
+        const int bx0 = bucketX(x_[size_t(i)]), bx1 = bucketX(x_[size_t(i)] + w_);
+        const int by0 = bucketY(y_[size_t(i)]), by1 = bucketY(y_[size_t(i)] + h_);
+        for (int by = by0; by <= by1; ++by)
+            for (int bx = bx0; bx <= bx1; ++bx)
+                items_[size_t(fill[size_t(by * bw_ + bx)]++)] = i;
+    }
+}
+
+int SeatSpatialIndex::seatAt(const QPointF& p) const {
+    if (items_.empty()) return -1;
+    const qreal x = p.x(), y = p.y();
+    if (x < ox_ || y < oy_) return -1;
+    const int bx = int((x - ox_) * invBucketW_);
+    const int by = int((y - oy_) * invBucketH_);
+    if (bx >= bw_ || by >= bh_) return -1;
+
+    const size_t b = size_t(by * bw_ + bx);
+    for (int k = start_[b]; k < start_[b + 1]; ++k) {
+        const int i = items_[size_t(k)];
+        if (hit(i, x, y)) return i;
+    }
+    return -1;
+}
+
+void SeatSpatialIndex::seatsIn(const QRectF& r, QVector<int>& out) const {
+    if (items_.empty() || r.isEmpty()) return;
+    const qreal L = r.left(), T = r.top(), R = r.right(), B = r.bottom();
+    const int qx0 = bucketX(L), qx1 = bucketX(R);
+    const int qy0 = bucketY(T), qy1 = bucketY(B);
+
+    for (int by = qy0; by <= qy1; ++by) {
+        for (int bx = qx0; bx <= qx1; ++bx) {
+            const size_t b = size_t(by * bw_ + bx);
+            for (int k = start_[b]; k < start_[b + 1]; ++k) {
+                const int i = items_[size_t(k)];
+                const qreal sx = x_[size_t(i)], sy = y_[size_t(i)];
+                if (sx >= R || sx + w_ <= L || sy >= B || sy + h_ <= T) continue;
+                // 去重：跨多个桶的座位只在“查询范围内它覆盖的第一个桶”里报告
+                if (qMax(bucketX(sx), qx0) != bx || qMax(bucketY(sy), qy0) != by) continue;
+                out.append(i);
+            }
+        }
+    }
+}
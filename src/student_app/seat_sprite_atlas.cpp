@@ -0,0 +1,63 @@
+#include <seatui/student/seat_sprite_atlas.hpp>
+#include <QImage>
+#include <QPainter>
+#include <QtMath>
+
+namespace {
+struct SeatStyle { QColor fill; QColor stroke; qreal width; };
+
+// 与原先逐个绘制的配色一致：空闲为深色底 + 浅描边
+const SeatStyle kStyles[int(SeatState::Count)] = {
+    { QColor(26, 34, 48,220),  QColor(130,160,180,110), 1.2 },   // Free
+    { QColor(88, 28, 35,220),  QColor(248,113,113,150), 1.2 },   // Occupied
+    { QColor(84, 62, 20,220),  QColor(251,191, 36,150), 1.2 },   // Reserved
+    { QColor(37, 99,235,110),  QColor( 56,189,248,230), 1.6 },   // Selected
+};
+}
+
+void SeatSpriteAtlas::rebuild(const QSizeF& seatSize, qreal radius, qreal dpr, bool supersample, bool detailed){
+    seatSize_ = seatSize;
+    radius_   = radius;
+    dpr_      = dpr;
+    ss_       = supersample;
+    detailed_ = detailed;
+    pixmap_   = QPixmap();
+    if (seatSize.isEmpty() || dpr <= 0) return;
+
+    // 精灵边界对齐到设备像素；逻辑尺寸由设备尺寸反推
+    cellDev_ = QSize(qCeil((seatSize.width()  + 2*kPad) * dpr),
+                     qCeil((seatSize.height() + 2*kPad) * dpr));
+    const QSizeF cellL(cellDev_.width() / dpr, cellDev_.height() / dpr);
+    const QPointF inset((cellL.width()  - seatSize.width())  / 2,
+                        (cellL.height() - seatSize.height()) / 2);
+
+    const int   n  = int(SeatState::Count);
+    const qreal ss = supersample ? 2.0 : 1.0;
+    QImage img(qCeil(cellDev_.width() * n * ss), qCeil(cellDev_.height() * ss),
+               QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::transparent);
+    {
+        QPainter p(&img);
+        p.setRenderHint(QPainter::Antialiasing, true);
+        p.scale(dpr * ss, dpr * ss);
+        for (int k = 0; k < n; ++k) {
+            const SeatStyle& st = kStyles[k];
+            const QRectF r(QPointF(k * cellL.width(), 0) + inset, seatSize);
+
+            p.setPen(Qt::NoPen);
+            p.setBrush(st.fill);
+            p.drawRoundedRect(r, radius, radius);
+            if (!detailed) continue;   // 远景：几个像素的座位上描边只会糊成一团
+
+            QPen pen(st.stroke);
+            pen.setWidthF(st.width);
+            p.setBrush(Qt::NoBrush);
+            p.setPen(pen);
+            p.drawRoundedRect(r, radius, radius);
+        }
+    }
+    if (ss != 1.0)
+        img = img.scaled(cellDev_.width() * n, cellDev_.height(),
+                         Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    pixmap_ = QPixmap::fromImage(std::move(img));
+}
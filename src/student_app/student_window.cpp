@@ -1,10 +1,13 @@
 #include <seatui/student/student_window.hpp>
 #include <seatui/launcher/login_window.hpp>
 #include <seatui/student/navigation_canvas.hpp>
+#include <seatui/widgets/heatmap_view.hpp>
 #include <QCheckBox>
 
 
 #include <QComboBox>
+#include <QLineEdit>
+#include <QRegularExpressionValidator>
 #include <QFrame>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -18,6 +21,7 @@
 #include <QImageReader>
 #include <QBuffer>
 #include <QDateTime>
+#include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QScrollArea>
@@ -33,6 +37,12 @@
 #include <QDebug>
 #include <QDebug>
 #include <seatui/widgets/card_dialog.hpp>
+#include <seatui/net/help_packet.hpp>
+#include <seatui/net/outbound_spool.hpp>
+#include <seatui/net/connection_manager.hpp>
+#include <seatui/net/message_router.hpp>
+#include <QStandardPaths>
+#include <seatui/student/image_ingest.hpp>
 
 // 侧边栏通用按钮
 static QPushButton* makeSideBtn(const QString& text, QWidget* parent) {
@@ -93,6 +103,12 @@ StudentWindow::StudentWindow(QWidget* parent) : QMainWindow(parent) {
     sideLy->addWidget(btnHelp);
     sideLy->addStretch();
 
+    // 底部：与管理员端的连接状态（悬停看 RTT 直方图）
+    connLbl_ = new QLabel(side);
+    connLbl_->setWordWrap(true);
+    connLbl_->setStyleSheet("color:#9ca3af; padding:4px; font-size:12px;");
+    sideLy->addWidget(connLbl_);
+
 
     // ===== 右侧页面区（堆叠）=====
     pages = new QStackedWidget(this);
@@ -190,9 +206,21 @@ QWidget* StudentWindow::buildNavigationPage() {
     ctrl->addSpacing(12);
     ctrl->addWidget(btnGen);
     ctrl->addWidget(btnClear);
+    ctrl->addSpacing(12);
+    tourEdit = new QLineEdit(page);
+    tourEdit->setPlaceholderText(u8"多个书架，如 ACD");
+    tourEdit->setMaximumWidth(140);
+    tourEdit->setValidator(new QRegularExpressionValidator(QRegularExpression("[A-Da-d]{0,8}"), tourEdit));
+    tourEdit->setToolTip(u8"依次输入要去的书架；已选座位也会作为途经点，访问顺序自动求解");
+    btnTour = new QPushButton(u8"多点路线", page);
+    ctrl->addWidget(tourEdit);
+    ctrl->addWidget(btnTour);
+    auto btnFit = new QPushButton(u8"复位视图", page);
+    btnFit->setToolTip(u8"滚轮缩放，右键/中键拖动平移；右键双击同样复位");
+    ctrl->addWidget(btnFit);
     ctrl->addStretch();
 
-    auto ssaaBox = new QCheckBox(u8"高质量抗锯齿(2×)", page);
+    auto ssaaBox = new QCheckBox(u8"高质量抗锯齿（空闲时超采样）", page);
     ssaaBox->setChecked(true);
     ctrl->addSpacing(12);
     ctrl->addWidget(ssaaBox);
@@ -206,20 +234,41 @@ QWidget* StudentWindow::buildNavigationPage() {
     navCanvas = canvasWidget;
 
     connect(ssaaBox, &QCheckBox::toggled, canvasWidget, &NavigationCanvas::setSuperSample);
+    connect(btnFit,  &QPushButton::clicked, canvasWidget, &NavigationCanvas::resetView);
+    connect(canvasWidget, &NavigationCanvas::selectionChanged, this, [this](int count){
+        navStatus->setText(count > 0 ? QString(u8"已选座位：%1 个（Ctrl 点选/框选可追加）").arg(count)
+                                     : QString(u8"已取消选座。"));
+    });
 
 
     // 底部状态
     navStatus = new QLabel(u8"提示：选择 A/B/C/D，点击“生成路径”。", page);
     navStatus->setStyleSheet("color:#93a4b5;");
+    auto perfLabel = new QLabel(page);
+    perfLabel->setStyleSheet("color:#64748b;");
+    connect(canvasWidget, &NavigationCanvas::routeFrameStats, perfLabel,
+            [perfLabel](double avgMs, double peakMs, int particles){
+        perfLabel->setText(QString(u8"路径动画 %1 ms/帧（峰值 %2，粒子 %3）")
+                               .arg(avgMs, 0, 'f', 2).arg(peakMs, 0, 'f', 2).arg(particles));
+    });
+    connect(canvasWidget, &NavigationCanvas::routeReplanned, this, [this](quint32 cost, double ms, int legs){
+        navStatus->setText(QString(u8"拥挤情况变化，已重新规划 %1 段路线（代价 %2，修复 %3 ms）")
+                               .arg(legs).arg(cost).arg(ms, 0, 'f', 2));
+    });
+    auto statusRow = new QHBoxLayout();
+    statusRow->addWidget(navStatus, 1);
+    statusRow->addWidget(perfLabel);
 
     // 布局安装
     root->addLayout(ctrl);
     root->addWidget(navCanvas, 1);
-    root->addWidget(navStatus);
+    root->addLayout(statusRow);
 
     // 信号槽
     connect(btnGen,   &QPushButton::clicked, this, &StudentWindow::onGenerate);
     connect(btnClear, &QPushButton::clicked, this, &StudentWindow::onClear);
+    connect(btnTour,  &QPushButton::clicked, this, &StudentWindow::onTour);
+    connect(tourEdit, &QLineEdit::returnPressed, this, &StudentWindow::onTour);
 
     // 快捷键
     btnGen->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_G));
@@ -239,14 +288,19 @@ QWidget* StudentWindow::buildHeatmapPage() {
     auto ly = new QVBoxLayout(page);
     ly->setContentsMargins(20,20,20,20);
 
-    auto lbl = new QLabel(u8"🔥 热力图占位页（后续接入）", page);
+    auto lbl = new QLabel(u8"🔥 实时座位热力图", page);
     lbl->setStyleSheet("color:#e5e7eb; font-weight:600;");
-    auto box = new QFrame(page);
-    box->setMinimumSize(680,440);
-    box->setStyleSheet("QFrame{ background:#111827; border:1px dashed #374151; border-radius:12px;}");
+    heatView = new HeatmapView(page);
+    heatView->setMinimumSize(680,440);
+    auto stat = new QLabel(u8"等待座位占用数据…", page);
+    stat->setStyleSheet("color:#64748b;");
+    connect(heatView, &HeatmapView::refreshed, stat, [stat](double ms){
+        stat->setText(QString(u8"热力图刷新 %1 ms").arg(ms, 0, 'f', 2));
+    });
 
     ly->addWidget(lbl);
-    ly->addWidget(box, 1);
+    ly->addWidget(heatView, 1);
+    ly->addWidget(stat);
     return page;
 }
 
@@ -311,6 +365,9 @@ QWidget* StudentWindow::buildHelpPage() {
 
     // —— 操作区 —— //
     auto op = new QHBoxLayout();
+    outboxLbl_ = new QLabel(page);
+    outboxLbl_->setStyleSheet("color:#66758a;");
+    op->addWidget(outboxLbl_);
     op->addStretch();
     helpResetBtn_  = new QPushButton(u8"重置", page);
     helpSubmitBtn_ = new QPushButton(u8"提交", page); helpSubmitBtn_->setEnabled(true);
@@ -319,6 +376,29 @@ QWidget* StudentWindow::buildHelpPage() {
     root->addLayout(op);
 
     // —— 事件 —— //
+    ingest_ = new ImageIngest(this);
+    connect(ingest_, &ImageIngest::previewReady, this, [this](quint64 gen, const QImage& preview){
+        if (gen != helpImgGen_) return;
+        helpImgPreview_->setPixmap(QPixmap::fromImage(preview));
+    });
+    connect(ingest_, &ImageIngest::encoded, this,
+            [this](quint64 gen, const QByteArray& bytes, const QString& mime, const QString& name, const QSize& size, double ms){
+        if (gen != helpImgGen_) return;
+        helpImgBytes_    = bytes;
+        helpImgMime_     = mime;
+        helpImgFilename_ = name;
+        helpImgPreview_->setToolTip(QString(u8"%1×%2，%3，%4 KB（处理 %5 ms）")
+                                        .arg(size.width()).arg(size.height()).arg(mime)
+                                        .arg(bytes.size() / 1024).arg(ms, 0, 'f', 0));
+        helpSubmitBtn_->setEnabled(true);
+    });
+    connect(ingest_, &ImageIngest::failed, this, [this](quint64 gen, const QString& why){
+        if (gen != helpImgGen_) return;
+        helpImgPreview_->setText(u8"（无图片）");
+        helpSubmitBtn_->setEnabled(true);
+        CardDialog(u8"读取失败", u8"无法读取该图片文件：" + why, this).exec();
+    });
+
     connect(helpPickBtn_,  &QPushButton::clicked, this, &StudentWindow::onPickImage);
     connect(helpResetBtn_, &QPushButton::clicked, this, &StudentWindow::onResetHelp);
     connect(helpSubmitBtn_,&QPushButton::clicked, this, &StudentWindow::onSubmitHelp);
@@ -347,16 +427,45 @@ void StudentWindow::onBackToLogin() {
 }
 
 
-/* ---------- 导航页按钮占位逻辑（下一步接绘制） ---------- */
+/* ---------- 导航页：生成 / 清除路径 ---------- */
 void StudentWindow::onGenerate() {
     const QString dest = destBox->currentText();
-    navStatus->setText(u8"已设置目标： " + dest + u8"（下一步在画布上绘制发光贝塞尔路径与粒子）");
-    // TODO：在 navCanvas 上绘制路径
+    if (!navCanvas->showRoute(destBox->currentIndex())) {
+        navStatus->setText(u8"未找到前往 " + dest + u8" 的可行路径。");
+        return;
+    }
+    const NavRouter& r = navCanvas->router();
+    navStatus->setText(QString(u8"已生成前往 %1 的路径（寻路 %2 ms%3）")
+                           .arg(dest)
+                           .arg(r.lastQueryMs(), 0, 'f', 3)
+                           .arg(r.lastWasCached() ? QString(u8"，缓存") : QString()));
+}
+
+void StudentWindow::onTour() {
+    QVector<int> shelves;
+    for (QChar c : tourEdit->text().toUpper())
+        if (c >= QLatin1Char('A') && c <= QLatin1Char('D')) shelves << (c.unicode() - 'A');
+    if (shelves.isEmpty() && navCanvas->selectedSeats().isEmpty()) {
+        navStatus->setText(u8"请输入要去的书架（如 ACD），或先在地图上选座。");
+        return;
+    }
+    if (!navCanvas->showTour(shelves)) {
+        navStatus->setText(u8"部分途经点不可达，无法生成多点路线。");
+        return;
+    }
+    const TourPlanner::Tour& t = navCanvas->lastTour();
+    QString text = QString(u8"多点路线：START → %1（%2，排序 %3 ms）")
+                       .arg(navCanvas->tourStops().join(u8" → "))
+                       .arg(t.exact ? QString(u8"最优顺序") : QString(u8"近似顺序"))
+                       .arg(t.ms, 0, 'f', 3);
+    if (const int dropped = navCanvas->tourSeatsDropped())
+        text += QString(u8"；途经座位过多，另有 %1 个未排入").arg(dropped);
+    navStatus->setText(text);
 }
 
 void StudentWindow::onClear() {
+    navCanvas->clearRoute();
     navStatus->setText(u8"已清除路径。");
-    // TODO：清空 navCanvas
 }
 
 
@@ -372,33 +481,18 @@ void StudentWindow::onPickImage() {
         );
     if (file.isEmpty()) return;
 
-    QImageReader reader(file);
-    reader.setAutoTransform(true);
-    QImage img = reader.read();
-    if (img.isNull()) {
-        CardDialog(u8"读取失败", u8"无法读取该图片文件。", this).exec(); // 复用你的卡片弹框
-        return;
-    }
-
-    // 预览：自适应缩放
-    const int maxW = 360, maxH = 200;
-    QImage scaled = img.scaled(maxW, maxH, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    helpImgPreview_->setPixmap(QPixmap::fromImage(scaled));
-    helpImgPreview_->setText(QString());
-
-    // 编码：优先 PNG
-    QByteArray bytes;
-    {
-        QBuffer buf(&bytes);
-        buf.open(QIODevice::WriteOnly);
-        img.save(&buf, "PNG", 6);
-    }
-    helpImgBytes_    = bytes;
-    helpImgFilename_ = QFileInfo(file).fileName();
-    helpImgMime_     = "image/png";
+    // 解码/预览/编码都在后台；编码完成前不能提交
+    helpImgBytes_.clear();
+    helpImgPreview_->setPixmap(QPixmap());
+    helpImgPreview_->setText(u8"正在处理图片…");
+    helpSubmitBtn_->setEnabled(false);
+    helpImgGen_ = ingest_->submit(file);
 }
 
 void StudentWindow::onResetHelp() {
+    ingest_->cancel();
+    helpImgGen_ = 0;
+    helpSubmitBtn_->setEnabled(true);
     helpText_->clear();
     helpImgPreview_->setPixmap(QPixmap());
     helpImgPreview_->setText(u8"（无图片）");
@@ -415,35 +509,26 @@ void StudentWindow::onSubmitHelp() {
         return;
     }
 
-    // —— 组装 JSON 载荷 —— //
-    QJsonObject root;
-    root["type"] = "student_help";
-    root["user"] = "student"; // 可替换成登录用户名/UID
-    root["description"] = desc;
-    root["created_at"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
-
+    // —— 组装二进制帧：定长头 + 原始图片字节（不再 base64 进 JSON） —— //
+    HelpPacket pkt;
+    pkt.requestId = ++helpSeq_;
+    pkt.createdMs = QDateTime::currentMSecsSinceEpoch();
+    pkt.user      = "student"; // 可替换成登录用户名/UID
+    pkt.text      = desc;
     if (!helpImgBytes_.isEmpty()) {
-        QJsonObject img;
-        img["filename"] = helpImgFilename_.isEmpty() ? "help.png" : helpImgFilename_;
-        img["mime"]     = helpImgMime_.isEmpty() ? "image/png" : helpImgMime_;
-        img["base64"]   = QString::fromLatin1(helpImgBytes_.toBase64());
-        root["image"]   = img;
+        pkt.filename = helpImgFilename_.isEmpty() ? "help.png" : helpImgFilename_;
+        pkt.mime     = helpImgMime_.isEmpty() ? "image/png" : helpImgMime_;
+        pkt.image    = helpImgBytes_;      // 隐式共享
     }
 
-    const QByteArray payload = QJsonDocument(root).toJson(QJsonDocument::Compact);
-    // qDebug() << "HELP JSON:" << payload;
-
-    // —— 发送：此处先占位 —— //
-    // TODO: 通过 WS 客户端发送到服务器 / 管理端：
-
-    // —— 发送到管理员端 —— //
-    wsSend(payload);
-
-    // wsClient_->sendTextMessage(QString::fromUtf8(payload));
-    // 或先写入 SQLite，后台服务/管理端拉取
+    // —— 发送到管理员端（先落盘；未连接时连上后自动补发） —— //
+    if (!wsSendBinary(pkt.encode())) return;   // 发件箱满：保留表单内容
 
     // 成功提示
-    CardDialog(u8"已提交", u8"你的求助信息已发送，管理员会尽快处理。", this).exec();
+    if (wsReady_)
+        CardDialog(u8"已提交", u8"你的求助信息已发送，管理员会尽快处理。", this).exec();
+    else
+        CardDialog(u8"已保存", u8"暂未连上管理员端，求助已保存在本机，连上后会自动发送。", this).exec();
 
     // 清空
     onResetHelp();
@@ -451,39 +536,105 @@ void StudentWindow::onSubmitHelp() {
 
 
 void StudentWindow::initWsClient() {
-    ws_ = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
+    // 重连（指数退避 + 抖动）与心跳由 ConnectionManager 负责
+    conn_ = new ConnectionManager(QUrl(QStringLiteral("ws://127.0.0.1:12345")), this);
+    ws_ = conn_->socket();
     ws_->ignoreSslErrors();  // 非 TLS
     wsReady_ = false;
 
+    connect(conn_, &ConnectionManager::stateChanged, this, &StudentWindow::updateConnLabel);
+    connect(conn_, &ConnectionManager::rttSampled, this, [this]{ updateConnLabel(conn_->state()); });
+    connect(conn_, &ConnectionManager::reconnectScheduled, this, [this]{ updateConnLabel(conn_->state()); });
+
+    // 发件箱：断线期间的上报落盘保存，连上后按序补发
+    outbox_ = new OutboundSpool(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation), this);
+    connect(outbox_, &OutboundSpool::backlogChanged, this, &StudentWindow::updateOutboxLabel);
+    updateOutboxLabel(outbox_->pendingCount(), outbox_->pendingBytes());
+
     connect(ws_, &QWebSocket::connected, this, [this]{
         wsReady_ = true;
-        // 可选：握手
-        ws_->sendTextMessage(QStringLiteral(R"({"type":"hello","role":"student"})"));
+        // 可选：握手（只对本次连接有意义，不进发件箱）
+        outbox_->sendNow(QStringLiteral(R"({"type":"hello","role":"student"})"));
+    });
+    outbox_->attach(ws_);   // 在握手之后接上，补发排在 hello 后面
+    connect(ws_, &QWebSocket::disconnected, this, [this]{ wsReady_ = false; });
+    connect(outbox_, &OutboundSpool::backlogChanged, this, [this]{ updateConnLabel(conn_->state()); });
+
+    // 管理端下发的文本消息按 type 分发；坏帧只计数，不打断界面
+    router_ = new MessageRouter(this);
+    router_->on("hello", [](QWebSocket*, QByteArrayView){ return true; });
+
+    // 管理端处理完一帧后回 {"type":"ack","seq":N}：发件箱据此推进确认偏移
+    router_->on("ack", [this](QWebSocket*, QByteArrayView m){
+        bool ok = false;
+        const quint64 seq = MessageRouter::member(m, "seq").toULongLong(&ok);
+        if (!ok) return false;
+        outbox_->acknowledge(seq);
+        return true;
+    });
+
+    // 实时座位占用：更新画布上的座位状态，在途路线由画布增量重规划
+    router_->on("seat_occupancy", [this](QWebSocket*, QByteArrayView m){
+        const QJsonDocument d = QJsonDocument::fromJson(m.toByteArray());
+        if (!d.isObject()) return false;
+        if (!navCanvas) return true;
+        const QJsonArray seats = d.object().value("seats").toArray();
+        bool ok = true;
+        for (const QJsonValue& v : seats) {
+            const QJsonObject s = v.toObject();
+            const int id = s.value("id").toInt(-1);
+            if (!SeatLayout::isValidKey(id)) { ok = false; continue; }   // 越界编号计入 rejected
+            const QString st = s.value("state").toString();
+            const SeatState state =
+                st == QLatin1String("occupied") ? SeatState::Occupied
+              : st == QLatin1String("reserved") ? SeatState::Reserved
+                                                : SeatState::Free;
+            navCanvas->setSeatState(id, state);
+            if (heatView) heatView->setSeatState(id, state);
+        }
+        return ok;
     });
-    connect(ws_, &QWebSocket::disconnected, this, [this]{
-        wsReady_ = false;
-        // 简单重连（本机单进程足够稳定，失连时延时重连）
-        QTimer::singleShot(1000, this, [this]{
-            ws_->open(QUrl(QStringLiteral("ws://127.0.0.1:12345")));
-        });
+    connect(ws_, &QWebSocket::textMessageReceived, this, [this](const QString& msg){
+        router_->dispatch(ws_, msg.toUtf8());
     });
-    connect(ws_, QOverload<QAbstractSocket::SocketError>::of(&QWebSocket::errorOccurred),
-            this, [this](auto){
-                // 首次连不上也尝试重连
-                QTimer::singleShot(1000, this, [this]{
-                    if (ws_ && !wsReady_) ws_->open(QUrl(QStringLiteral("ws://127.0.0.1:12345")));
-                });
-            });
 
     // 首次连接
-    ws_->open(QUrl(QStringLiteral("ws://127.0.0.1:12345")));
+    conn_->start();
 }
 
-void StudentWindow::wsSend(const QByteArray& utf8Json) {
-    if (ws_ && wsReady_) {
-        ws_->sendTextMessage(QString::fromUtf8(utf8Json));
-    } else {
-        // 兜底：连不上就提醒（不丢数据也行：可选入本地队列/DB）
-        CardDialog(u8"未连接", u8"尚未连接管理员端（WS）。稍后将自动重试。", this).exec();
+void StudentWindow::updateConnLabel(ConnectionManager::State st) {
+    if (!connLbl_) return;
+    const RttHistogram& rtt = conn_->rtt();
+    QString text;
+    switch (st) {
+    case ConnectionManager::State::Connected:
+        text = rtt.count() ? QString(u8"● 已连接 · %1 ms").arg(rtt.last(), 0, 'f', 1) : QString(u8"● 已连接");
+        break;
+    case ConnectionManager::State::Connecting:
+        text = u8"◌ 正在连接…";
+        break;
+    case ConnectionManager::State::Backoff:
+        text = QString(u8"○ 未连接 · %1 s 后重试").arg((conn_->retryInMs() + 999) / 1000);
+        break;
+    case ConnectionManager::State::Idle:
+        text = u8"○ 未连接";
+        break;
     }
+    if (outbox_ && outbox_->pendingCount() > 0)
+        text += QString(u8"\n待发送 %1 条").arg(outbox_->pendingCount());
+    connLbl_->setText(text);
+    connLbl_->setToolTip(rtt.histogramText());
+}
+
+bool StudentWindow::wsSendBinary(const QByteArray& frame) {
+    if (outbox_->enqueue(OutboundSpool::Kind::Binary, frame)) return true;
+    CardDialog(u8"发送失败", u8"本机待发送的消息过多（或无法写入磁盘），请稍后再试。", this).exec();
+    return false;
+}
+
+void StudentWindow::updateOutboxLabel(int messages, qint64 bytes) {
+    if (!outboxLbl_) return;
+    outboxLbl_->setText(messages > 0
+        ? QString(u8"待发送 %1 条（%2 KB）").arg(messages).arg((bytes + 1023) / 1024)
+        : QString());
 }
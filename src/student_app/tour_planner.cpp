@@ -0,0 +1,111 @@
+#include <seatui/student/tour_planner.hpp>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <vector>
+
+TourPlanner::Tour TourPlanner::solve(const QVector<quint32>& dist, int n){
+    QElapsedTimer t; t.start();
+    Tour tour;
+    if (n < 2 || dist.size() < n * n) return tour;
+
+    // 起点到任一点不可达则整条路线无解（网格无向，可达性对称）
+    for (int j = 1; j < n; ++j)
+        if (dist.at(j) == kInf) { tour.ms = t.nsecsElapsed() / 1e6; return tour; }
+
+    tour = (n - 1 <= kExactLimit) ? heldKarp(dist, n) : nearestNeighbour2Opt(dist, n);
+    tour.ms = t.nsecsElapsed() / 1e6;
+    return tour;
+}
+
+quint64 TourPlanner::pathCost(const QVector<quint32>& dist, int n, const QVector<int>& order){
+    quint64 c = 0;
+    int prev = 0;
+    for (int v : order) { c += dist.at(prev * n + v); prev = v; }
+    return c;
+}
+
+TourPlanner::Tour TourPlanner::heldKarp(const QVector<quint32>& dist, int n){
+    // 途经点 1..m 映射到位 0..m-1；dp[mask][j] = 从起点出发恰好访问 mask、停在 j 的最小代价
+    const int m = n - 1;
+    const int full = 1 << m;
+    constexpr quint64 INF = ~quint64(0);
+    std::vector<quint64> dp(size_t(full) * m, INF);
+    std::vector<qint8>   par(size_t(full) * m, -1);
+
+    for (int j = 0; j < m; ++j) dp[size_t(1 << j) * m + j] = dist.at(j + 1);
+
+    for (int mask = 1; mask < full; ++mask) {
+        for (int j = 0; j < m; ++j) {
+            const quint64 cur = dp[size_t(mask) * m + j];
+            if (cur == INF || !(mask & (1 << j))) continue;
+            const quint32* row = dist.constData() + (j + 1) * n + 1;
+            for (int k = 0; k < m; ++k) {
+                if (mask & (1 << k) || row[k] == kInf) continue;
+                const int nm = mask | (1 << k);
+                const quint64 c = cur + row[k];
+                quint64& slot = dp[size_t(nm) * m + k];
+                if (c < slot) { slot = c; par[size_t(nm) * m + k] = qint8(j); }
+            }
+        }
+    }
+
+    Tour tour;
+    int last = -1;
+    quint64 best = INF;
+    for (int j = 0; j < m; ++j)
+        if (dp[size_t(full - 1) * m + j] < best) { best = dp[size_t(full - 1) * m + j]; last = j; }
+    if (last < 0) return tour;
+
+    // 回溯
+    tour.order.resize(m);
+    int mask = full - 1;
+    for (int pos = m - 1; pos >= 0; --pos) {
+        tour.order[pos] = last + 1;
+        const int p = par[size_t(mask) * m + last];
+        mask &= ~(1 << last);
+        last = p;
+    }
+    tour.cost  = best;
+    tour.exact = true;
+    return tour;
+}
+
+TourPlanner::Tour TourPlanner::nearestNeighbour2Opt(const QVector<quint32>& dist, int n){
+    Tour tour;
+    // —— 最近邻构造 —— //
+    std::vector<char> used(size_t(n), 0);
+    used[0] = 1;
+    int cur = 0;
+    tour.order.reserve(n - 1);
+    for (int step = 1; step < n; ++step) {
+        int next = -1;
+        for (int k = 1; k < n; ++k)
+            if (!used[size_t(k)] && (next < 0 || dist.at(cur * n + k) < dist.at(cur * n + next))) next = k;
+        if (dist.at(cur * n + next) == kInf) return Tour();
+        used[size_t(next)] = 1;
+        tour.order << next;
+        cur = next;
+    }
+
+    // —— 2-opt：反转 order[i..k]，起点固定、终点开放 —— //
+    auto d = [&](int a, int b) -> quint64 { return dist.at(a * n + b); };
+    QVector<int>& o = tour.order;
+    const int m = o.size();
+    for (bool improved = true; improved; ) {
+        improved = false;
+        for (int i = 0; i < m - 1; ++i) {
+            const int a = i == 0 ? 0 : o.at(i - 1);
+            for (int k = i + 1; k < m; ++k) {
+                const int b = o.at(i), c = o.at(k);
+                const quint64 before = d(a, b) + (k + 1 < m ? d(c, o.at(k + 1)) : 0);
+                const quint64 after  = d(a, c) + (k + 1 < m ? d(b, o.at(k + 1)) : 0);
+                if (after < before) {
+                    std::reverse(o.begin() + i, o.begin() + k + 1);
+                    improved = true;
+                }
+            }
+        }
+    }
+    tour.cost = pathCost(dist, n, o);
+    return tour;
+}
@@ -0,0 +1,306 @@
+#include <seatui/widgets/heatmap_engine.hpp>
+#include <seatui/student/seat_layout.hpp>
+#include <QColor>
+#include <QElapsedTimer>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define SEATUI_HEAT_SSE2 1
+#  include <emmintrin.h>
+#endif
+
+namespace {
+// out[i] += a * in[i]
+inline void axpy(float* out, const float* in, float a, int n){
+    int i = 0;
+#ifdef SEATUI_HEAT_SSE2
+    const __m128 va = _mm_set1_ps(a);
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(va, _mm_loadu_ps(in + i))));
+#endif
+    for (; i < n; ++i) out[i] += a * in[i];
+}
+}
+
+void HeatmapEngine::setLayout(const SeatLayout& lay){
+    const qreal cell = qMax(1, lay.prm.cell);
+    w_ = lay.gridCols * kSub;
+    h_ = lay.gridRows * kSub;
+    stride_ = (w_ + 3) & ~3;
+    world_ = QRectF(lay.gridRect);
+
+    // 座位可见矩形 → 密度像素范围（半开区间，取覆盖中心的像素）
+    const int n = lay.seatCount();
+    seatValue_.fill(0.f, n);
+    seatPx_.resize(n);
+    const qreal s = kSub / cell;
+    for (int i = 0; i < n; ++i) {
+        const QRectF r = lay.seatRect(i).translated(-world_.topLeft());
+        const int x0 = qBound(0, qRound(r.left()   * s), w_), x1 = qBound(0, qRound(r.right()  * s), w_);
+        const int y0 = qBound(0, qRound(r.top()    * s), h_), y1 = qBound(0, qRound(r.bottom() * s), h_);
+        seatPx_[i] = QRect(x0, y0, x1 - x0, y1 - y0);
+    }
+
+    raw_.assign(size_t(stride_) * h_, 0.f);
+    tmp_.assign(raw_.size(), 0.f);
+    blur_.assign(raw_.size(), 0.f);
+    image_ = QImage(qMax(1, w_), qMax(1, h_), QImage::Format_ARGB32_Premultiplied);
+    image_.fill(Qt::transparent);
+
+    buildKernel();
+    if (lut_[255] == 0) buildLut();
+    profLen_[0] = profLen_[1] = -1;
+    full_  = true;
+    dirty_ = QRect();
+
+    // 增益：单个满占用座位模糊后的峰值 = 两个方向上核在座位宽度内的和之积
+    if (n > 0) {
+        auto mass = [&](int len){
+            float acc = 0.f;
+            for (int k = -radius_; k <= radius_; ++k)
+                if (k >= -len / 2 && k < len - len / 2) acc += kernel_[size_t(k + radius_)];
+            return acc;
+        };
+        const float peak = mass(seatPx_.at(0).width()) * mass(seatPx_.at(0).height());
+        gain_ = peak > 0.f ? 1.f / peak : 1.f;
+    }
+}
+
+QRect HeatmapEngine::setSeatValue(int seat, float v){
+    if (seat < 0 || seat >= seatValue_.size()) return QRect();
+    v = qBound(0.f, v, 1.f);
+    const float dv = v - seatValue_.at(seat);
+    if (dv == 0.f) return QRect();
+    seatValue_[seat] = v;
+    if (full_) return dirtyRect();              // 反正要全量重算
+
+    if (++stamps_ >= kResyncStamps) { full_ = true; return dirtyRect(); }
+    return stamp(seat, dv);
+}
+
+void HeatmapEngine::setSeatValues(const QVector<float>& v){
+    for (int i = 0; i < seatValue_.size(); ++i)
+        seatValue_[i] = qBound(0.f, v.value(i, 0.f), 1.f);
+    full_ = true;
+}
+
+QRect HeatmapEngine::loadDensity(const std::vector<float>& grid, int gridStride, int level, const QVector<float>& seatValues){
+    for (int i = 0; i < seatValue_.size(); ++i)
+        seatValue_[i] = qBound(0.f, seatValues.value(i, 0.f), 1.f);
+    full_   = false;
+    stamps_ = 0;
+    dirty_  = QRect(0, 0, w_, h_);
+    if (w_ <= 0 || h_ <= 0) return QRect();
+
+    if (level <= 0) {
+        for (int y = 0; y < h_; ++y)
+            std::copy(grid.data() + size_t(y) * gridStride, grid.data() + size_t(y) * gridStride + w_,
+                      blur_.data() + size_t(y) * stride_);
+        return dirty_;
+    }
+
+    // 降采样图（每像素覆盖 2^level × 2^level）双线性放大；密度本身已模糊过，放大不会出现块状
+    const int f  = 1 << level;
+    const int gw = (w_ + f - 1) / f, gh = (h_ + f - 1) / f;
+    auto src = [&](int x, int y){ return grid[size_t(qBound(0, y, gh - 1)) * gridStride + qBound(0, x, gw - 1)]; };
+    for (int y = 0; y < h_; ++y) {
+        const float fy = (y + 0.5f) / f - 0.5f;
+        const int   y0 = int(std::floor(fy));
+        const float v  = fy - y0;
+        float* out = blur_.data() + size_t(y) * stride_;
+        for (int x = 0; x < w_; ++x) {
+            const float fx = (x + 0.5f) / f - 0.5f;
+            const int   x0 = int(std::floor(fx));
+            const float u  = fx - x0;
+            const float top = src(x0, y0)     + u * (src(x0 + 1, y0)     - src(x0, y0));
+            const float bot = src(x0, y0 + 1) + u * (src(x0 + 1, y0 + 1) - src(x0, y0 + 1));
+            out[x] = top + v * (bot - top);
+        }
+    }
+    return dirty_;
+}
+
+QRectF HeatmapEngine::toWorld(const QRect& px) const {
+    if (px.isEmpty() || w_ <= 0 || h_ <= 0) return QRectF();
+    const qreal sx = world_.width() / w_, sy = world_.height() / h_;
+    return QRectF(world_.left() + px.left() * sx, world_.top() + px.top() * sy,
+                  px.width() * sx, px.height() * sy);
+}
+
+// 长度为 len 的方框与高斯核的卷积：长 len + 2r，第 i 个值 = 核落在方框内的权重和
+int HeatmapEngine::profile(int len, int keep){
+    for (int k = 0; k < 2; ++k)
+        if (profLen_[k] == len) return k;
+    const int k = keep == 0 ? 1 : 0;
+    profLen_[k] = len;
+    std::vector<float>& out = prof_[k];
+    out.assign(size_t(len + 2 * radius_), 0.f);
+    for (int i = 0; i < int(out.size()); ++i) {
+        float acc = 0.f;
+        const int c = i - radius_;              // 相对方框起点的位置
+        for (int j = qMax(0, c - radius_); j <= qMin(len - 1, c + radius_); ++j)
+            acc += kernel_[size_t(j - c + radius_)];
+        out[size_t(i)] = acc;
+    }
+    return k;
+}
+
+QRect HeatmapEngine::stamp(int seat, float dv){
+    const QRect& r = seatPx_.at(seat);
+    if (r.isEmpty()) return QRect();
+    const int ix = profile(r.width());
+    const int iy = profile(r.height(), ix);
+    const std::vector<float>& px = prof_[ix];
+    const std::vector<float>& py = prof_[iy];
+
+    // 盖章范围 = 座位外扩 r 像素，裁到图内
+    const QRect area = r.adjusted(-radius_, -radius_, radius_, radius_) & QRect(0, 0, w_, h_);
+    const int ox = r.left() - radius_, oy = r.top() - radius_;
+    for (int y = area.top(); y <= area.bottom(); ++y) {
+        const float a = dv * py[size_t(y - oy)];
+        axpy(blur_.data() + size_t(y) * stride_ + area.left(), px.data() + (area.left() - ox), a, area.width());
+    }
+    dirty_ |= area;
+    return area;
+}
+
+void HeatmapEngine::buildKernel(){
+    const double sigma = kSigmaCells * kSub;
+    radius_ = qMax(1, qCeil(3.0 * sigma));
+    kernel_.resize(size_t(2 * radius_ + 1));
+    double sum = 0;
+    for (int k = -radius_; k <= radius_; ++k) {
+        const double v = std::exp(-0.5 * k * k / (sigma * sigma));
+        kernel_[size_t(k + radius_)] = float(v);
+        sum += v;
+    }
+    for (float& v : kernel_) v = float(v / sum);
+}
+
+void HeatmapEngine::buildLut(){
+    // 冷 → 热：透明蓝 → 青 → 绿 → 黄 → 红；透明度随强度上升，低值几乎不可见
+    struct Stop { float t; QColor c; };
+    const Stop stops[] = {
+        { 0.00f, QColor( 37, 99,235,   0) },
+        { 0.20f, QColor( 56,189,248, 110) },
+        { 0.45f, QColor( 74,222,128, 160) },
+        { 0.70f, QColor(250,204, 21, 200) },
+        { 1.00f, QColor(239, 68, 68, 230) },
+    };
+    for (int i = 0; i < 256; ++i) {
+        const float t = i / 255.f;
+        int k = 0;
+        while (k + 2 < int(std::size(stops)) && t > stops[k + 1].t) ++k;
+        const Stop& a = stops[k];
+        const Stop& b = stops[k + 1];
+        const float u = qBound(0.f, (t - a.t) / (b.t - a.t), 1.f);
+        auto mix = [u](int x, int y){ return int(x + (y - x) * u + 0.5f); };
+        const QColor c(mix(a.c.red(), b.c.red()), mix(a.c.green(), b.c.green()),
+                       mix(a.c.blue(), b.c.blue()), mix(a.c.alpha(), b.c.alpha()));
+        lut_[i] = qPremultiply(c.rgba());
+    }
+}
+
+void HeatmapEngine::refresh(){
+    QElapsedTimer t; t.start();
+    if (w_ > 0 && h_ > 0) {
+        accumulate();
+        blurRows(raw_.data(), tmp_.data());
+        blurCols(tmp_.data(), blur_.data());
+        colorize(QRect(0, 0, w_, h_));
+    }
+    full_   = false;
+    dirty_  = QRect();
+    stamps_ = 0;
+    lastMs_ = t.nsecsElapsed() / 1e6;
+}
+
+QRect HeatmapEngine::flush(){
+    if (full_) { refresh(); return QRect(0, 0, w_, h_); }
+    const QRect done = dirty_;
+    if (done.isEmpty()) return done;
+    QElapsedTimer t; t.start();
+    colorize(done);
+    dirty_  = QRect();
+    lastMs_ = t.nsecsElapsed() / 1e6;
+    return done;
+}
+
+void HeatmapEngine::accumulate(){
+    std::fill(raw_.begin(), raw_.end(), 0.f);
+    for (int i = 0; i < seatPx_.size(); ++i) {
+        const float v = seatValue_.at(i);
+        if (v <= 0.f) continue;
+        const QRect& r = seatPx_.at(i);
+        for (int y = r.top(); y <= r.bottom(); ++y) {
+            float* row = raw_.data() + size_t(y) * stride_;
+            for (int x = r.left(); x <= r.right(); ++x) row[x] += v;
+        }
+    }
+}
+
+// 横向：整行拷进两侧补零的行缓冲，之后每 4 个输出像素一组做乘加
+void HeatmapEngine::blurRows(const float* src, float* dst) const {
+    const int r = radius_, taps = 2 * r + 1;
+    const float* w = kernel_.data();
+    line_.assign(size_t(stride_ + 2 * r), 0.f);
+    float* line = line_.data();
+    for (int y = 0; y < h_; ++y) {
+        const float* in = src + size_t(y) * stride_;
+        float* out = dst + size_t(y) * stride_;
+        std::copy(in, in + w_, line + r);
+#ifdef SEATUI_HEAT_SSE2
+        for (int x = 0; x < stride_; x += 4) {
+            __m128 acc = _mm_setzero_ps();
+            for (int k = 0; k < taps; ++k)
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[k]), _mm_loadu_ps(line + x + k)));
+            _mm_storeu_ps(out + x, acc);
+        }
+#else
+        for (int x = 0; x < w_; ++x) {
+            float acc = 0.f;
+            for (int k = 0; k < taps; ++k) acc += w[k] * line[x + k];
+            out[x] = acc;
+        }
+#endif
+    }
+}
+
+// 纵向：逐行累加上下 r 行，每次处理一整行（4 路并行），访存连续
+void HeatmapEngine::blurCols(const float* src, float* dst) const {
+    const int r = radius_;
+    const float* w = kernel_.data();
+    for (int y = 0; y < h_; ++y) {
+        float* out = dst + size_t(y) * stride_;
+        std::fill(out, out + stride_, 0.f);
+        const int k0 = qMax(-r, -y), k1 = qMin(r, h_ - 1 - y);
+        for (int k = k0; k <= k1; ++k)
+            axpy(out, src + size_t(y + k) * stride_, w[k + r], stride_);
+    }
+}
+
+// 密度 × 增益 → 0..255 色表下标 → 直接写扫描线
+void HeatmapEngine::colorize(const QRect& px){
+    const float scale = 255.f * gain_;
+    const int x0 = px.left() & ~3, x1 = px.right() + 1;
+    for (int y = px.top(); y <= px.bottom(); ++y) {
+        const float* in = blur_.data() + size_t(y) * stride_;
+        quint32* out = reinterpret_cast<quint32*>(image_.scanLine(y));
+#ifdef SEATUI_HEAT_SSE2
+        const __m128 vs = _mm_set1_ps(scale), lo = _mm_setzero_ps(), hi = _mm_set1_ps(255.f);
+        alignas(16) qint32 idx[4];
+        for (int x = x0; x < x1; x += 4) {
+            const __m128 v = _mm_min_ps(hi, _mm_max_ps(lo, _mm_mul_ps(_mm_loadu_ps(in + x), vs)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(idx), _mm_cvttps_epi32(v));
+            const int n = qMin(4, x1 - x);
+            for (int i = 0; i < n; ++i) out[x + i] = lut_[idx[i]];
+        }
+#else
+        for (int x = x0; x < x1; ++x)
+            out[x] = lut_[int(qBound(0.f, in[x] * scale, 255.f))];
+#endif
+    }
+}
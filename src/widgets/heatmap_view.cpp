@@ -0,0 +1,98 @@
+#include <seatui/widgets/heatmap_view.hpp>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+
+HeatmapView::HeatmapView(QWidget* parent) : QWidget(parent) {
+    setMinimumSize(480, 320);
+    setAttribute(Qt::WA_OpaquePaintEvent, true);
+}
+
+float HeatmapView::occupancyOf(SeatState s){
+    return s == SeatState::Occupied ? 1.f : s == SeatState::Reserved ? 0.5f : 0.f;
+}
+
+void HeatmapView::setSeatState(int id, SeatState s){
+    if (!SeatLayout::isValidKey(id) || s == SeatState::Selected || seatState(id) == s) return;
+    if (s == SeatState::Free) state_.remove(id);
+    else                      state_.insert(id, quint8(s));
+
+    const int seat = lay_.indexOf(id);
+    if (seat < 0) return;
+    // 只重绘本次盖章波及的范围；同一帧内的多次更新由 Qt 合并成一个损伤区域
+    repaintPixels(engine_.setSeatValue(seat, occupancyOf(s)));
+}
+
+void HeatmapView::repaintPixels(const QRect& px){
+    if (!px.isEmpty()) update(engine_.toWorld(px).toAlignedRect().adjusted(-1, -1, 1, 1));
+}
+
+void HeatmapView::resizeEvent(QResizeEvent*){
+    lay_ = SeatLayout::build(SeatLayout::Params(), width(), height());
+    engine_.setLayout(lay_);
+    for (auto it = state_.constBegin(); it != state_.constEnd(); ++it) {
+        const int seat = lay_.indexOf(it.key());
+        if (seat >= 0) engine_.setSeatValue(seat, occupancyOf(SeatState(it.value())));
+    }
+    selArea_ = QRectF();
+    emit layoutChanged();
+}
+
+void HeatmapView::mousePressEvent(QMouseEvent* e){
+    if (e->button() != Qt::LeftButton) return;
+    selecting_ = true;
+    selAnchor_ = e->position();
+    update(selArea_.toAlignedRect().adjusted(-2, -2, 2, 2));
+    selArea_ = QRectF();
+}
+
+void HeatmapView::mouseMoveEvent(QMouseEvent* e){
+    if (!selecting_) return;
+    const QRectF old = selArea_;
+    selArea_ = QRectF(selAnchor_, e->position()).normalized();
+    update((old | selArea_).toAlignedRect().adjusted(-2, -2, 2, 2));
+}
+
+void HeatmapView::mouseReleaseEvent(QMouseEvent* e){
+    if (!selecting_ || e->button() != Qt::LeftButton) return;
+    selecting_ = false;
+    if (selArea_.width() < 4 || selArea_.height() < 4) selArea_ = QRectF();   // 单击取消框选
+    emit areaSelected(selArea_);
+}
+
+void HeatmapView::paintEvent(QPaintEvent* e){
+    // 只着色脏矩形（布局变化后为全图）
+    if (engine_.isDirty()) {
+        engine_.flush();
+        emit refreshed(engine_.lastMs());
+    }
+
+    const QRectF exposed = e->rect();
+    QPainter p(this);
+    p.setClipRect(e->rect());
+    p.fillRect(e->rect(), QColor(10,14,24));
+
+    // 底图：书架与座位轮廓（只画与损伤区域相交的）
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setPen(QPen(QColor(51,65,85), 1));
+    p.setBrush(QColor(17,24,39));
+    for (int i = 0; i < lay_.seatCount(); ++i) {
+        const QRectF r = lay_.seatRect(i);
+        if (r.intersects(exposed)) p.drawRoundedRect(r, 4, 4);
+    }
+    p.setPen(QColor(148,163,184));
+    p.setBrush(Qt::NoBrush);
+    for (int i = 0; i < lay_.shelfRects.size(); ++i)
+        p.drawText(lay_.shelfRects.at(i), Qt::AlignCenter, QString(QChar('A' + i)));
+
+    // 热力层：低分辨率密度图平滑放大到网格区域
+    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    p.drawImage(engine_.worldRect(), engine_.image());
+
+    if (!selArea_.isEmpty()) {
+        p.setPen(QPen(QColor(226,232,240), 1, Qt::DashLine));
+        p.setBrush(QColor(226,232,240,24));
+        p.drawRect(selArea_);
+    }
+}
@@ -0,0 +1,70 @@
+#include <seatui/widgets/occupancy_table.hpp>
+#include <algorithm>
+
+void OccupancyTable::setLayout(const SeatLayout& lay){
+    cols_ = lay.seatCols;
+    rows_ = lay.seatRows;
+    for (auto& plane : sat_) plane.assign(size_t(cols_ + 1) * (rows_ + 1), 0);
+    state_.fill(quint8(SeatState::Free), lay.seatCount());
+
+    // 行优先编号：首行给出每列中心，首列给出每行中心
+    colX_.assign(size_t(cols_), 0.f);
+    rowY_.assign(size_t(rows_), 0.f);
+    const float hw = float(lay.seatSize.width() / 2), hh = float(lay.seatSize.height() / 2);
+    for (int i = 0; i < lay.seatCount(); ++i) {
+        if (lay.seatRow.at(i) == 0) colX_[size_t(lay.seatCol.at(i))] = lay.seatX.at(i) + hw;
+        if (lay.seatCol.at(i) == 0) rowY_[size_t(lay.seatRow.at(i))] = lay.seatY.at(i) + hh;
+    }
+
+    // 书架分区：各分区覆盖的连续列
+    zones_.fill(QRect(), lay.shelfRects.size());
+    for (int i = 0; i < lay.seatCount() && lay.seatRow.at(i) == 0; ++i) {
+        const int z = lay.seatZone.at(i), c = lay.seatCol.at(i);
+        if (z < 0 || z >= zones_.size()) continue;
+        QRect& r = zones_[z];
+        r = r.isNull() ? QRect(c, 0, 1, rows_) : r.united(QRect(c, 0, 1, rows_));
+    }
+}
+
+void OccupancyTable::bump(int plane, int col, int row, int delta){
+    // 前缀和 S(x, y) 覆盖 [0,x)×[0,y)：座位 (col,row) 计入所有 x > col、y > row 的项
+    const int stride = cols_ + 1;
+    for (int y = row + 1; y <= rows_; ++y) {
+        qint32* line = sat_[plane].data() + size_t(y) * stride;
+        for (int x = col + 1; x <= cols_; ++x) line[x] += delta;
+    }
+}
+
+bool OccupancyTable::setSeatState(int seat, SeatState s){
+    if (seat < 0 || seat >= state_.size() || s == SeatState::Selected) return false;
+    const SeatState old = SeatState(state_.at(seat));
+    if (old == s) return false;
+    state_[seat] = quint8(s);
+
+    const int col = seat % cols_, row = seat / cols_;
+    if (old == SeatState::Occupied) bump(Occupied, col, row, -1);
+    if (old == SeatState::Reserved) bump(Reserved, col, row, -1);
+    if (s   == SeatState::Occupied) bump(Occupied, col, row, +1);
+    if (s   == SeatState::Reserved) bump(Reserved, col, row, +1);
+    return true;
+}
+
+ZoneOccupancy OccupancyTable::query(const QRect& cells) const {
+    const QRect r = cells & QRect(0, 0, cols_, rows_);
+    ZoneOccupancy z;
+    if (r.isEmpty()) return z;
+    const int x0 = r.left(), y0 = r.top(), x1 = r.right() + 1, y1 = r.bottom() + 1;
+    auto sum = [&](int p){ return at(p, x1, y1) - at(p, x0, y1) - at(p, x1, y0) + at(p, x0, y0); };
+    z.seats    = r.width() * r.height();
+    z.occupied = sum(Occupied);
+    z.reserved = sum(Reserved);
+    return z;
+}
+
+ZoneOccupancy OccupancyTable::queryWorld(const QRectF& world) const {
+    const int c0 = int(std::lower_bound(colX_.begin(), colX_.end(), float(world.left()))   - colX_.begin());
+    const int c1 = int(std::upper_bound(colX_.begin(), colX_.end(), float(world.right()))  - colX_.begin());
+    const int r0 = int(std::lower_bound(rowY_.begin(), rowY_.end(), float(world.top()))    - rowY_.begin());
+    const int r1 = int(std::upper_bound(rowY_.begin(), rowY_.end(), float(world.bottom())) - rowY_.begin());
+    return query(QRect(c0, r0, c1 - c0, r1 - r0));
+}